@@ -0,0 +1,128 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using std::string;
+
+namespace yas6502
+{
+    /**
+     * Convert arena text to a string
+     */
+    string str(const Text &text)
+    {
+        return string(text.data, text.length);
+    }
+
+    /**
+     * Write arena text to a stream
+     */
+    std::ostream &operator <<(std::ostream &out, const Text &text)
+    {
+        return out.write(text.data, text.length);
+    }
+
+    const size_t Arena::BLOCK_SIZE;
+
+    /**
+     * Construct an empty arena. No memory is allocated until the
+     * first object is.
+     */
+    Arena::Arena()
+        : blocksUsed_(0)
+        , next_(nullptr)
+        , end_(nullptr)
+    {
+    }
+
+    /**
+     * Free everything in the arena.
+     */
+    void Arena::clear()
+    {
+        blocksUsed_ = 0;
+        next_ = nullptr;
+        end_ = nullptr;
+    }
+
+    /**
+     * Return the current allocation point.
+     */
+    Arena::Mark Arena::mark() const
+    {
+        return Mark{ blocksUsed_, next_, end_ };
+    }
+
+    /**
+     * Free everything allocated since `mark' was taken. The blocks
+     * are kept.
+     */
+    void Arena::rewind(const Mark &mark)
+    {
+        blocksUsed_ = mark.blocksUsed;
+        next_ = mark.next;
+        end_ = mark.end;
+    }
+
+    /**
+     * Allocate raw memory with the given alignment, which must be a
+     * power of two.
+     */
+    void *Arena::allocate(size_t size, size_t align)
+    {
+        size_t pad = (0 - reinterpret_cast<uintptr_t>(next_)) & (align - 1);
+
+        // Move on to the next block if this one is full. If a request
+        // is too big for the next kept block, that block is just
+        // skipped for this assembly.
+        //
+        while (static_cast<size_t>(end_ - next_) < pad + size) {
+            if (blocksUsed_ == blocks_.size()) {
+                size_t blockSize = std::max(BLOCK_SIZE, size + align);
+                blocks_.push_back(Block{ std::unique_ptr<char[]>(new char[blockSize]), blockSize });
+            }
+
+            Block &block = blocks_[blocksUsed_++];
+            next_ = block.data.get();
+            end_ = next_ + block.size;
+            pad = (0 - reinterpret_cast<uintptr_t>(next_)) & (align - 1);
+        }
+
+        char *p = next_ + pad;
+        next_ = p + size;
+        return p;
+    }
+
+    /**
+     * Copy a string into the arena
+     */
+    Text Arena::text(const string &s)
+    {
+        char *data = static_cast<char *>(allocate(s.length(), 1));
+        std::memcpy(data, s.data(), s.length());
+        return Text{ data, s.length() };
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace yas6502
+{
+    // A counted run of objects, usually in an arena.
+    //
+    template<typename T>
+    struct Span
+    {
+        T *data;
+        size_t length;
+
+        T *begin() const { return data; }
+        T *end() const { return data + length; }
+        size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+        T &operator[](size_t i) const { return data[i]; }
+    };
+
+    using Text = Span<const char>;
+
+    extern std::string str(const Text &text);
+    extern std::ostream &operator <<(std::ostream &out, const Text &text);
+
+    // Owns the storage for one assembly's AST. Allocation just bumps a
+    // pointer through large blocks, and clearing the arena frees
+    // everything at once by starting over at the first block, which
+    // keeps the blocks for the next assembly.
+    //
+    // Nothing in the arena is ever destroyed, so only trivially
+    // destructible types may be put in it.
+    //
+    class Arena
+    {
+    public:
+        // A point in the arena to go back to, freeing everything 
+        // allocated after it.
+        //
+        struct Mark
+        {
+            size_t blocksUsed;
+            char *next;
+            char *end;
+        };
+
+        Arena();
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void clear();
+        Mark mark() const;
+        void rewind(const Mark &mark);
+        void *allocate(size_t size, size_t align);
+
+        template<typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        Span<const T> copy(const std::vector<T> &items)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+
+            T *data = static_cast<T *>(allocate(items.size() * sizeof(T), alignof(T)));
+            std::uninitialized_copy(items.begin(), items.end(), data);
+            return Span<const T>{ data, items.size() };
+        }
+
+        Text text(const std::string &s);
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<char[]> data;
+            size_t size;
+        };
+
+        static const size_t BLOCK_SIZE = 64 * 1024;
+
+        std::vector<Block> blocks_;
+        size_t blocksUsed_;
+        char *next_;
+        char *end_;
+    };
+}
+
+#endif
@@ -22,7 +22,6 @@
 #include "parser.h"
 
 #include "except.h"
-#include "opcodes.h"
 #include "pass1.h"
 #include "pass2.h"
 #include "scanner.h"
@@ -44,9 +43,6 @@ using std::vector;
 
 using ss = std::stringstream;
 
-extern FILE *yyin;
-extern int yy_flex_debug;
-
 namespace yas6502
 {
     /**
@@ -54,9 +50,36 @@ namespace yas6502
      */
     Assembler::Assembler()
         : trace_(false)
-        , source_(nullptr)
+        , jobs_(1)
+        , singlePass_(false)
+        , flexScanner_(false)
+        , arenaMark_(arena_.mark())
+        , codeMark_(0)
+    {
+    }
+
+    /**
+     * Set the number of threads pass 2 may use.
+     */
+    void Assembler::setJobs(int jobs)
+    {
+        jobs_ = jobs;
+    }
+
+    /**
+     * Turn single pass assembly on or off.
+     */
+    void Assembler::setSinglePass(bool singlePass)
     {
-        opcodes_ = opcodes::makeOpcodeMap();
+        singlePass_ = singlePass;
+    }
+
+    /**
+     * Choose the flex scanner or the hand written one.
+     */
+    void Assembler::setFlexScanner(bool flex)
+    {
+        flexScanner_ = flex;
     }
 
     /**
@@ -76,30 +99,31 @@ namespace yas6502
     }
 
     /**
-     * Check if the given string is an opcode. The scanner uses this to
-     * distinguish opcodes from identifiers.
+     * Record a syntax error. These are reported along with the errors
+     * from the passes rather than printed, so that each assembly's
+     * diagnostics stay together.
      */
-    bool Assembler::isOpcode(const std::string &op) const
+    void Assembler::syntaxError(const yy::location &loc, const string &message)
     {
-        return opcodes_.find(op) != opcodes_.end();
+        syntaxErrors_.push_back(Message{ false, static_cast<int>(loc.begin.line), message });
     }
 
     /**
      * Run the parser
      */
-    void Assembler::parse(vector<char> &source)
+    void Assembler::parse(char *source, size_t length)
     {
         location_.initialize(&file_);
 
-        yy_flex_debug = trace_;
-
-        source_ = source.data();
-        yy::parser parse(*this);
+        // All scanner state lives in `scanner' and all parser state in
+        // `parse', so nothing here is shared with other Assembler objects.
+        //
+        ScannerType type = flexScanner_ ? ScannerType::Flex : ScannerType::Table;
+        unique_ptr<Scanner> scanner = makeScanner(type, source, length, trace_);
+        yy::parser parse(*this, *scanner);
 
         parse.set_debug_level(trace_);
         parse();
-        cleanUpScanner();
-        source_ = nullptr;
     }
 
     /**
@@ -107,33 +131,182 @@ namespace yas6502
      */
     void Assembler::assemble(const string &filename, vector<char> &source)
     {
-        file_ = filename;
-        program_.clear();
-
+        size_t length = source.size();
         source.push_back(0);
         source.push_back(0);
-        parse(source);
+        assemble(filename, source.data(), length);
+    }
 
+    /**
+     * Parse and assemble the given file, which the caller has already
+     * terminated with two NUL bytes.
+     */
+    void Assembler::assemble(const string &filename, char *source, size_t length)
+    {
+        file_ = filename;
+        program_.clear();
+        fixups_.clear();
+        reserved_.clear();
+        syntaxErrors_.clear();
         symtab_.clear();
-        pass1_ = make_unique<Pass1>( symtab_, opcodes_ );
-        pass2_ = make_unique<Pass2>( symtab_, opcodes_ );
+        code_.clear();
+        arena_.clear();
+        arenaMark_ = arena_.mark();
+        codeMark_ = code_.mark();
 
-        pass1_->pass1(program_);
-        if (pass1_->errors() == 0) {
-            pass2_->pass2(program_);
+        pass1_ = make_unique<Pass1>( symtab_ );
+        pass2_ = make_unique<Pass2>( symtab_ );
+
+        // Statements usually end with a newline, so this normally saves
+        // reallocating the program as it grows. Nothing depends on it
+        // staying in place; it's only an optimization.
+        //
+        if (!singlePass_) {
+            program_.reserve(std::count(source, source + length, '\n'));
+        }
+
+        parse(source, length);
+
+        if (singlePass_) {
+            finishSinglePass();
+            return;
+        }
+
+        if (syntaxErrors_.empty() && pass1_->errors() == 0) {
+            // Pass 2 can only be split up if no symbols will change 
+            // during it.
+            //
+            int jobs = (pass1_->deferredSets() == 0) ? jobs_ : 1;
+            pass2_->pass2(program_, jobs);
         }
     }
     
+    /**
+     * Take a statement from the parser, and place it with pass 1 
+     * right away. In two pass mode, the statement is kept for pass 2.
+     * In single pass mode, it's emitted right away too. If that works, 
+     * it's done with, and the arena and code buffer are rewound to free
+     * it; otherwise it's kept as a fixup. Only the fixups are ever kept,
+     * so memory use doesn't grow with the size of the source.
+     */
+    void Assembler::statement(ast::Node *node)
+    {
+        // The parse stops at the first syntax error, and once there's
+        // been one, nothing more is assembled; otherwise the passes 
+        // would report symbols defined after the error as undefined.
+        //
+        if (!syntaxErrors_.empty()) {
+            return;
+        }
+
+        pass1_->pass1(node);
+
+        if (!singlePass_) {
+            program_.push_back(node);
+            return;
+        }
+
+        // As in two pass mode, nothing is emitted once pass 1 has
+        // failed.
+        //
+        if (pass1_->errors() == 0) {
+            int begin = pass2_->loc();
+            int size = node->fixesLocation() ? 0 : pass1_->loc() - node->loc();
+
+            if (!pass2_->emitNow(node, size)) {
+                reserve(begin, begin + size, node->line());
+                fixups_.push_back(Fixup{ node, size });
+                arenaMark_ = arena_.mark();
+                codeMark_ = code_.mark();
+                return;
+            }
+
+            checkReserved(begin, node->fixesLocation() ? begin : pass2_->loc());
+        }
+
+        arena_.rewind(arenaMark_);
+        code_.rewind(codeMark_);
+    }
+
+    /**
+     * Note that the bytes from `begin' up to `end' belong to the 
+     * fixup on `line', and will only be written at the end of the
+     * assembly.
+     */
+    void Assembler::reserve(int begin, int end, int line)
+    {
+        begin = std::max(begin, 0);
+        end = std::min(end, int{ Image::SIZE });
+
+        if (begin >= end) {
+            return;
+        }
+
+        if (reserved_.empty()) {
+            reserved_.resize(Image::SIZE);
+        }
+
+        std::fill(reserved_.begin() + begin, reserved_.begin() + end, line);
+    }
+
+    /**
+     * A statement which was emitted right away wrote the bytes from
+     * `begin' up to `end'. If an earlier fixup will write over any of 
+     * them, the image would differ from a two pass assembly, where the
+     * later statement wins; so that's an error in single pass mode.
+     */
+    void Assembler::checkReserved(int begin, int end)
+    {
+        if (reserved_.empty()) {
+            return;
+        }
+
+        begin = std::max(begin, 0);
+        end = std::min(end, int{ Image::SIZE });
+
+        for (int addr = begin; addr < end; addr++) {
+            if (reserved_[addr] != 0) {
+                ss err{};
+                err
+                    << "In single pass mode, this may not overwrite the bytes of line "
+                    << reserved_[addr]
+                    << ", which refers to symbols that were not yet defined.";
+                pass2_->error(err.str());
+                return;
+            }
+        }
+    }
+
+    /**
+     * Finish single pass assembly by emitting the fixups, now that 
+     * every symbol that will be defined is. If there were errors before
+     * then, there's no image, as in two pass mode.
+     */
+    void Assembler::finishSinglePass()
+    {
+        if (!syntaxErrors_.empty() || pass1_->errors() != 0) {
+            fixups_.clear();
+            pass2_ = make_unique<Pass2>( symtab_ );
+            return;
+        }
+
+        for (const Fixup &fixup : fixups_) {
+            pass2_->fixup(fixup.node, fixup.size);
+        }
+    }
+
     /**
      * Return the number of errors.
      */
     int Assembler::errors() const
     {
-        if (pass1_ == nullptr || pass2_ == nullptr) {
-            return 0;
+        int errors = static_cast<int>(syntaxErrors_.size());
+
+        if (pass1_ != nullptr && pass2_ != nullptr) {
+            errors += pass1_->errors() + pass2_->errors();
         }
 
-        return pass1_->errors() + pass2_->errors();
+        return errors;
     }
 
     /**
@@ -153,7 +326,7 @@ namespace yas6502
      */
     vector<Message> Assembler::messages() const
     {
-        vector<Message> ret{};
+        vector<Message> ret{ syntaxErrors_ };
 
         if (pass1_ != nullptr && pass2_ != nullptr) {
             std::copy(pass1_->messages().begin(), pass1_->messages().end(), std::back_inserter(ret));
@@ -185,14 +358,23 @@ namespace yas6502
     /**
      * Return the AST of the program
      */
-    const vector<unique_ptr<ast::Node>> &Assembler::program() const
+    const vector<ast::Node *> &Assembler::program() const
     {
         return program_;
     }
 
 
     /**
-     * Return the symbol table
+     * Return the symbol table. The scanner uses this to intern
+     * identifiers.
+     */
+    SymbolTable &Assembler::symtab()
+    {
+        return symtab_;
+    }
+
+    /**
+     * const version of symtab
      */
     const SymbolTable &Assembler::symtab() const
     {
@@ -200,18 +382,18 @@ namespace yas6502
     }
 
     /**
-     * Return a buffer containing the source code
+     * Return the expression code buffer
      */
-    char *Assembler::source()
+    ast::ExpressionCode &Assembler::code()
     {
-        return source_;
+        return code_;
     }
 
     /**
-     * Called by the parser to set the program when parsing is done.
+     * Return the arena which holds the AST
      */
-    void Assembler::setProgram(vector<unique_ptr<ast::Node>> &&program)
+    Arena &Assembler::arena()
     {
-        program_ = std::move(program);
+        return arena_;
     }
 }
@@ -47,44 +47,88 @@ namespace yas6502
         Assembler();
 
         void setTrace();
+
+        // The number of threads pass 2 may use.
+        void setJobs(int jobs);
+
+        // Assemble each statement as it's parsed, without keeping the
+        // program. There is no listing in this mode.
+        void setSinglePass(bool singlePass);
+
+        // Scan with the flex scanner rather than the hand written one.
+        // Throws when the source is assembled if the library was built 
+        // without it.
+        void setFlexScanner(bool flex);
+
+        // Note that the scanner WILL write to the source buffer. The
+        // program refers to text in the buffer, so it must be kept
+        // until the program and its listing are done with.
         void assemble(const std::string &filename, std::vector<char> &source);
 
+        // Assemble a buffer owned by the caller, without copying it. The
+        // `length' bytes of source must be followed by two NUL bytes, and
+        // as above the scanner will write to the buffer.
+        void assemble(const std::string &filename, char *source, size_t length);
+
         int errors() const;
         int warnings() const; 
         std::vector<Message> messages() const;
         const Image &image() const;
-        const std::vector<std::unique_ptr<ast::Node>> &program() const;
+        const std::vector<ast::Node *> &program() const;
+        SymbolTable &symtab();
         const SymbolTable &symtab() const;
-        
-        // This is only valid during parse() and is to communicate the
-        // source to the scanner. Note that the scanner WILL write to
-        // the buffer.
-        char *source();
 
-        // The parser calls this at the end of parsing to give back
-        // the AST.
-        void setProgram(std::vector<std::unique_ptr<ast::Node>> &&program);
+        // The parser compiles expressions into this buffer, and
+        // allocates the rest of the AST from the arena.
+        ast::ExpressionCode &code();
+        Arena &arena();
+
+        // The parser calls this with each statement as it's parsed.
+        void statement(ast::Node *node);
 
         yy::location &loc();
         const yy::location &loc() const;
 
-        bool isOpcode(const std::string &op) const;
+        // The parser calls this to report a syntax error.
+        void syntaxError(const yy::location &loc, const std::string &message);
 
     private:
-        opcodes::OpcodeMap opcodes_;
-
-        char *source_;
         std::string file_;
         yy::location location_;
         bool trace_;
+        int jobs_;
+        bool singlePass_;
+        bool flexScanner_;
 
+        std::vector<Message> syntaxErrors_;
         SymbolTable symtab_;
+        ast::ExpressionCode code_;
+        Arena arena_;
         std::unique_ptr<Pass1> pass1_;
         std::unique_ptr<Pass2> pass2_;
 
-        std::vector<std::unique_ptr<ast::Node>> program_;
-
-        void parse(std::vector<char> &source);
+        std::vector<ast::Node *> program_;
+
+        // A statement waiting for symbols in single pass mode, and the
+        // number of bytes left for it.
+        struct Fixup
+        {
+            ast::Node *node;
+            int size;
+        };
+
+        // Single pass state: the statements waiting for symbols, the
+        // line of the one which will write each address (or 0), and
+        // where to rewind to once a statement has been assembled.
+        std::vector<Fixup> fixups_;
+        std::vector<int> reserved_;
+        Arena::Mark arenaMark_;
+        uint32_t codeMark_;
+
+        void parse(char *source, size_t length);
+        void reserve(int begin, int end, int line);
+        void checkReserved(int begin, int end);
+        void finishSinglePass();
     };
 }
 
@@ -21,13 +21,13 @@
  **/
 
 #include "ast.h"
+#include "symtab.h"
 
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
 
 using std::string;
-using std::unique_ptr;
 using std::vector;
 
 using ss = std::stringstream;
@@ -43,13 +43,8 @@ namespace yas6502
             : line_(0)
             , loc_(0)
             , nextLoc_(0)
-        {
-        }
-
-        /**
-         * Destructor
-         */
-        Node::~Node()
+            , label_(NO_SYMBOL)
+            , comment_(Text{ nullptr, 0 })
         {
         }
 
@@ -81,7 +76,7 @@ namespace yas6502
         /**
          * Set the label for this line.
          */
-        void Node::setLabel(const std::string &label)
+        void Node::setLabel(int label)
         {
             label_ = label;
         }
@@ -89,7 +84,7 @@ namespace yas6502
         /**
          * Set the comment for this line.
          */
-        void Node::setComment(const std::string &comment)
+        void Node::setComment(const Text &comment)
         {
             comment_ = comment;
         }
@@ -119,30 +114,87 @@ namespace yas6502
             return nextLoc_ - loc_;
         }
 
+        /**
+         * Return true if pass 2 of this node sets the location counter
+         * to the same value no matter what it was before.
+         */
+        bool Node::fixesLocation() const
+        {
+            return false;
+        }
+
+        /**
+         * Construct an empty data element.
+         */
+        DataElement::DataElement()
+        {
+        }
+
         /**
          * Construct a data element.
          */
-        DataElement::DataElement(ExpressionPtr &&count, ExpressionPtr &&value)
-            : count(std::move(count))
-            , value(std::move(value))
+        DataElement::DataElement(const Expression &count, const Expression &value)
+            : count(count)
+            , value(value)
         {
         }
 
         /**
          * Construct an initialized data node
          */
-        DataNode::DataNode(DataSize size, vector<unique_ptr<DataElement>>&&data)
+        DataNode::DataNode(DataSize size, const Span<const DataElement> &data)
             : size_(size)
-            , data_(std::move(data))
+            , data_(data)
+            , packed_(Span<const uint8_t>{ nullptr, 0 })
         {
         }
 
+        /**
+         * Construct a data node from a packed list of constants
+         */
+        DataNode::DataNode(DataSize size, const Span<const uint8_t> &packed)
+            : size_(size)
+            , data_(Span<const DataElement>{ nullptr, 0 })
+            , packed_(packed)
+        {
+        }
+
+        /**
+         * Make the node for a BYTE or WORD statement. If every element
+         * is a plain constant that fits, the list is packed, and its code, 
+         * which starts at `codeMark', is thrown away.
+         */
+        Node *makeDataNode(Arena &arena, ExpressionCode &code, uint32_t codeMark, DataSize size, const vector<DataElement> &data)
+        {
+            size_t width = (size == DataSize::Byte) ? 1 : 2;
+            int limit = (size == DataSize::Byte) ? 0xFF : 0xFFFF;
+
+            int value;
+            for (const DataElement &ele : data) {
+                if (!ele.count.empty() || !ele.value.literal(value) || value < 0 || value > limit) {
+                    return arena.make<DataNode>(size, arena.copy(data));
+                }
+            }
+
+            uint8_t *bytes = static_cast<uint8_t *>(arena.allocate(data.size() * width, 1));
+            for (size_t i = 0; i < data.size(); i++) {
+                data[i].value.literal(value);
+                bytes[i * width] = value & 0xFF;
+                if (width == 2) {
+                    bytes[i * width + 1] = value >> 8;
+                }
+            }
+
+            code.rewind(codeMark);
+            return arena.make<DataNode>(size, Span<const uint8_t>{ bytes, data.size() * width });
+        }
+
         /**
          * Construct an uninitialized data node
          */
-        SpaceNode::SpaceNode(DataSize size, ExpressionPtr count)
+        SpaceNode::SpaceNode(DataSize size, const Expression &count)
             : size_(size)
-            , count_(std::move(count))
+            , count_(count)
         {
         }
 
@@ -157,7 +209,7 @@ namespace yas6502
         /** 
          * Construct a string node
          */
-        StringNode::StringNode(const string &str, bool nulTerminate)
+        StringNode::StringNode(const Text &str, bool nulTerminate)
             : str_(str)
             , nulTerminate_(nulTerminate)
         {
@@ -166,18 +218,25 @@ namespace yas6502
         /**
          * Construct an instruction node
          */
-        InstructionNode::InstructionNode(std::string &opcode, AddressPtr address)
-            : opcode_(opcode)
-            , address_(std::move(address))
+        InstructionNode::InstructionNode(opcodes::Mnemonic mnemonic, const Text &spelling, const Address &address)
+            : opcode_(spelling)
+            , instruction_(opcodes::instruction(mnemonic))
+            , address_(address)
+            , clockCycles_(0)
+            , hasExtraClockCycles_(false)
+            , undocumented_(false)
+            , unstable_(false)
             , operandSize_(DataSize::Byte)
+            , operandKnown_(false)
+            , operand_(0)
         {
         }
 
         /**
          * Construct an ORG node, which sets the location counter.
          */
-        OrgNode::OrgNode(ExpressionPtr locExpr)
-            : locExpr_(std::move(locExpr))
+        OrgNode::OrgNode(const Expression &locExpr)
+            : locExpr_(locExpr)
             , computedLoc_(0)
         {
         }
@@ -191,10 +250,19 @@ namespace yas6502
             return 0;
         }
 
+        /**
+         * An ORG fixes the location counter unless its expression 
+         * depends on the location counter itself.
+         */
+        bool OrgNode::fixesLocation() const
+        {
+            return !locExpr_.usesLocation();
+        }
+
         /**
          * Construct a symbol assignment node
          */
-        SetNode::SetNode(const std::string &symbol, ExpressionPtr value)
+        SetNode::SetNode(int symbol, const Expression &value)
             : symbol_(symbol)
             , value_(std::move(value))
         {
@@ -209,95 +277,281 @@ namespace yas6502
         }
 
         /**
-         * Base class expression
+         * Construct an empty expression
          */
         Expression::Expression()
-            : parenthesized_(false)
+            : code_(nullptr)
+            , offset_(0)
+            , length_(0)
+            , depth_(0)
+            , parenthesized_(false)
         {
         }
 
         /**
-         * Base class destructor
+         * Check if this is the empty expression, which stands for
+         * an optional expression that is not there.
          */
-        Expression::~Expression()
+        bool Expression::empty() const
         {
+            return length_ == 0;
+        }
+
+        /** 
+         * Check if this expression is parenthesized
+         */
+        bool Expression::parenthesized() const
+        {
+            return parenthesized_;
         }
 
         /**
-         * Set that this expression is parenthesized
+         * Check if this expression is a constant, either as written or by
+         * folding, and if so return its value.
          */
-        void Expression::setParenthesized()
+        bool Expression::constant(int &value) const
         {
-            parenthesized_ = true;
+            if (empty()) {
+                return false;
+            }
+
+            const Insn &first = *begin();
+            if (first.type == InsnType::Constant && length_ == 1) {
+                value = first.operand;
+                return true;
+            }
+
+            if (first.type == InsnType::Folded && first.skip + 1u == length_) {
+                value = first.operand;
+                return true;
+            }
+
+            return false;
         }
 
-        /** 
-         * Check if this expression is parenthesized
+        /**
+         * Check if this expression is just a constant as written, and if
+         * so return its value.
          */
-        bool Expression::parenthesized() const
+        bool Expression::literal(int &value) const
         {
-            return parenthesized_;
+            if (length_ != 1 || begin()->type != InsnType::Constant) {
+                return false;
+            }
+
+            value = begin()->operand;
+            return true;
         }
 
         /**
-         * Construct an address
+         * Return the first instruction of the expression's code
          */
-        Address::Address(AddrMode mode, ExpressionPtr address)
-            : mode_(mode)
-            , address_(std::move(address))
+        const Insn *Expression::begin() const
         {
+            return code_ == nullptr ? nullptr : code_->at(offset_);
         }
 
         /**
-         * Get the addressing mode
+         * Return a pointer just past the expression's code
          */
-        AddrMode Address::mode() const
+        const Insn *Expression::end() const
         {
-            return mode_;
+            return begin() + length_;
         }
 
         /**
-         * Get the address expression. Can be nullptr for
-         * some modes.
+         * Throw away all code, which invalidates every expression
+         * made from this buffer.
          */
-        Expression *Address::addressExpr() const
+        void ExpressionCode::clear()
         {
-            return address_.get();
+            code_.clear();
         }
 
         /**
-         * Construct a unary operator
+         * Return the current end of the code, to rewind to.
          */
-        UnaryOp::UnaryOp(Operator op, ExpressionPtr operand)
-            : op_(op)
-            , operand_(std::move(operand))
+        uint32_t ExpressionCode::mark() const
         {
+            return static_cast<uint32_t>(code_.size());
         }
 
         /**
-         * Construct a binary operator
+         * Throw away all code emitted since `mark' was taken, which 
+         * invalidates every expression made since then.
          */
-        BinaryOp::BinaryOp(Operator op, ExpressionPtr left, ExpressionPtr right)
-            : op_(op)
-            , left_(std::move(left))
-            , right_(std::move(right))
+        void ExpressionCode::rewind(uint32_t mark)
         {
+            code_.resize(mark);
         }
 
         /**
-         * Construct a symbol expression
+         * Return the instruction at the given offset
          */
-        SymbolExpression::SymbolExpression(const std::string &symbol)
-            : symbol_(symbol)
+        const Insn *ExpressionCode::at(uint32_t offset) const
+        {
+            return code_.data() + offset;
+        }
+
+        /**
+         * Emit a constant
+         */
+        Expression ExpressionCode::constant(int value)
+        {
+            return leaf(InsnType::Constant, value);
+        }
+
+        /**
+         * Emit a symbol reference
+         */
+        Expression ExpressionCode::symbol(int symbol)
+        {
+            return leaf(InsnType::Symbol, symbol);
+        }
+
+        /**
+         * Emit a reference to the location counter
+         */
+        Expression ExpressionCode::location()
+        {
+            return leaf(InsnType::Location, 0);
+        }
+
+        /**
+         * Emit a unary operator. `operand' must be the code just emitted.
+         */
+        Expression ExpressionCode::unary(Operator op, const Expression &operand)
         {
+            code_.push_back(Insn{ InsnType::Unary, op, 0, 0 });
+
+            Expression expr{ operand };
+            expr.length_++;
+            expr.parenthesized_ = false;
+
+            int value;
+            if (operand.constant(value)) {
+                return fold(expr, applyUnary(op, value));
+            }
+
+            return expr;
         }
 
         /**
-         * Construct a constant expression
+         * Emit a binary operator. `left' and `right' must be the code just
+         * emitted, in that order. Evaluating `right' needs one more stack
+         * entry since `left' is still on the stack.
+         */
+        Expression ExpressionCode::binary(Operator op, const Expression &left, const Expression &right)
+        {
+            code_.push_back(Insn{ InsnType::Binary, op, 0, 0 });
+
+            Expression expr{ left };
+            expr.length_ += right.length_ + 1;
+            expr.depth_ = std::max<uint16_t>(left.depth_, right.depth_ + 1);
+            expr.parenthesized_ = false;
+
+            // Division by zero is left to be reported when the expression
+            // is evaluated, like any other error.
+            //
+            int leftValue;
+            int rightValue;
+            if (left.constant(leftValue) && right.constant(rightValue)) {
+                bool divides = op == Operator::Div || op == Operator::Mod;
+                if (!divides || rightValue != 0) {
+                    return fold(expr, applyBinary(op, leftValue, rightValue));
+                }
+            }
+
+            return expr;
+        }
+
+        /**
+         * Mark an expression as having been written in parentheses. There is
+         * no code for this.
+         */
+        Expression ExpressionCode::parenthesized(const Expression &expr)
+        {
+            Expression paren{ expr };
+            paren.parenthesized_ = true;
+            return paren;
+        }
+
+        /**
+         * Emit a single instruction expression
+         */
+        Expression ExpressionCode::leaf(InsnType type, int operand)
+        {
+            Expression expr{};
+            expr.code_ = this;
+            expr.offset_ = static_cast<uint32_t>(code_.size());
+            expr.length_ = 1;
+            expr.depth_ = 1;
+
+            code_.push_back(Insn{ type, Operator::Add, 0, operand });
+            return expr;
+        }
+
+        /**
+         * Fold `expr', which must be the code just emitted, to the given
+         * value by putting a Folded instruction in front of its code. If
+         * its first operand was already folded, that instruction is reused,
+         * so long constant chains don't keep moving the code.
+         */
+        Expression ExpressionCode::fold(const Expression &expr, int value)
+        {
+            if (expr.length_ > UINT16_MAX) {
+                return expr;
+            }
+
+            Expression result{ expr };
+            result.depth_ = 1;
+
+            Insn &first = code_[expr.offset_];
+            if (first.type == InsnType::Folded) {
+                first.operand = value;
+                first.skip = static_cast<uint16_t>(expr.length_ - 1);
+                return result;
+            }
+
+            Insn folded{ InsnType::Folded, Operator::Add, static_cast<uint16_t>(expr.length_), value };
+            code_.insert(code_.begin() + expr.offset_, folded);
+
+            result.length_++;
+            return result;
+        }
+
+        /**
+         * Construct an implied address
+         */
+        Address::Address()
+            : mode_(AddrMode::Implied)
+        {
+        }
+
+        /**
+         * Construct an address
+         */
+        Address::Address(AddrMode mode, const Expression &address)
+            : mode_(mode)
+            , address_(address)
+        {
+        }
+
+        /**
+         * Get the addressing mode
+         */
+        AddrMode Address::mode() const
+        {
+            return mode_;
+        }
+
+        /**
+         * Get the address expression. Can be nullptr for
+         * some modes.
          */
-        ConstantExpression::ConstantExpression(int value)
-            : value_(value)
+        const Expression *Address::addressExpr() const
         {
+            return address_.empty() ? nullptr : &address_;
         }
     }
 }
@@ -22,7 +22,11 @@
 #ifndef AST_H_
 #define AST_H_
 
-#include <array>
+#include "arena.h"
+#include "image.h"
+#include "opcodes.h"
+
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <set>
@@ -31,171 +35,158 @@
 
 namespace yas6502
 {
+    class ListingBuffer;
     class Pass;
     class Pass1;
     class Pass2;
-
-    using Image = std::array<int, 65536>;
+    class SymbolTable;
 
     namespace ast
     {
-        class Expression;
-        using ExpressionPtr = std::unique_ptr<Expression>;
-
-        class Address;
-        using AddressPtr = std::unique_ptr<Address>;
-
-        class Node
+        // The value of an OPCODE token: the mnemonic the scanner matched
+        // and the spelling it was matched from, in the source buffer.
+        //
+        struct Opcode
         {
-        public:
-            Node();
-            virtual ~Node();
-
-            void setLine(int line);
-            void setLoc(int loc);
-            void setNextLoc(int loc);
-            void setLabel(const std::string &label);
-            void setComment(const std::string &comment);
-
-            int line() const;
-            int loc() const;
-            virtual int length() const;
-            virtual std::string attributes() const;
-
-            std::vector<std::string> str(const Image &image);
-
-            virtual void pass1(Pass1 &pass1);
-            virtual void pass2(Pass2 &pass2);
-
-        protected:
-            virtual std::string toString() = 0;
-
-            int line_;
-            int loc_;
-            int nextLoc_;  // the location of the following instruction
-            std::string label_;
-            std::string comment_;
+            opcodes::Mnemonic mnemonic;
+            Text spelling;
         };
 
-        using NodePtr = std::unique_ptr<Node>;
-
-        class NoopNode : public Node
+        enum class Operator : uint8_t
         {
-        public:
-
-        protected:
-            virtual std::string toString() override;
-        };
-
-        enum class DataSize
-        {
-            Byte,
-            Word,
+            Add,
+            Sub,
+            Mul,
+            Div,
+            Mod,
+            Neg,
+            LShift,
+            RShift,
+            And,
+            Or,
+            Xor,
+            BitNeg
         };
 
-        struct DataElement
-        {
-            ExpressionPtr count;
-            ExpressionPtr value;
+        int applyUnary(Operator op, int operand);
+        int applyBinary(Operator op, int left, int right);
 
-            DataElement(ExpressionPtr &&count, ExpressionPtr &&value);
-        };
+        class Expression;
 
-        class DataNode : public Node
+        // The result of evaluating an expression. Results are made on
+        // every evaluation in both passes, so they never allocate; the
+        // first few undefined symbols are kept as spelling IDs, and the
+        // names are only looked up if they are reported.
+        //
+        class ExprResult
         {
         public:
-            DataNode(DataSize size, std::vector<std::unique_ptr<DataElement>> &&data);
+            static const int MAX_UNDEFINED = 4;
 
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual std::string toString() override;
-
-        private:
-            DataSize size_;
-            std::vector<std::unique_ptr<DataElement>> data_;
-        };
+            // Leaves the result unset, for evaluation stacks.
+            ExprResult() = default;
+            ExprResult(int value);
 
-        class SpaceNode : public Node
-        {
-        public:
-            SpaceNode(DataSize size, ExpressionPtr count);
+            static ExprResult undefinedSymbol(int symbol);
+            void addUndefined(const ExprResult &other);
 
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual int length() const override;
-            virtual std::string toString() override;
+            bool defined() const;
+            int value() const;
+            std::set<std::string> undefinedSymbols(const SymbolTable &symtab, const Expression &expr) const;
 
         private:
-            ExpressionPtr count_;
-            DataSize size_;
+            int value_;
+            bool defined_;
+            bool overflow_;
+            int undefinedCount_;
+            int undefined_[MAX_UNDEFINED];
         };
 
-        class StringNode : public Node
+        // Expressions are compiled by the parser into postfix code for
+        // a stack machine. The parser reduces operands before their
+        // operators, so emitting each instruction as its rule is reduced
+        // leaves every subexpression as a contiguous run of code.
+        //
+        // Operators whose operands are all constant are folded as they are
+        // emitted. The operator's code is kept for the listing, and a Folded
+        // instruction holding the value is put in front of it; evaluation
+        // pushes the value and skips the original code.
+        //
+        enum class InsnType : uint8_t
         {
-        public:
-            StringNode(const std::string &str, bool nulTerminate);
-
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual std::string toString() override;
+            Constant,
+            Symbol,
+            Location,
+            Unary,
+            Binary,
+            Folded,
+        };
 
-        private:
-            std::string str_;
-            bool nulTerminate_;
+        struct Insn
+        {
+            InsnType type;
+            Operator op;
+            uint16_t skip;  // for Folded, the length of the original code
+            int operand;    // constant or folded value, or symbol spelling ID
         };
 
-        class InstructionNode : public Node
+        class ExpressionCode;
+
+        // An expression is a run of code in an ExpressionCode buffer, and
+        // is a small value type. An empty expression stands for a missing
+        // optional one.
+        //
+        class Expression
         {
         public:
-            InstructionNode(std::string &opcode, AddressPtr address);
+            Expression();
 
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual std::string toString() override;
+            bool empty() const;
+            bool parenthesized() const;
+            bool constant(int &value) const;
+            bool literal(int &value) const;
 
-            virtual std::string attributes() const override;
+            void format(ListingBuffer &out, const SymbolTable &symtab) const;
+            ExprResult eval(Pass &pass) const;
+            void collectUndefined(const SymbolTable &symtab, std::set<std::string> &names) const;
+            bool usesLocation() const;
 
         private:
-            std::string opcode_;
-            AddressPtr address_;
-            int clockCycles_;
-            bool hasExtraClockCycles_;
-            bool undocumented_;
-            bool unstable_;
+            friend class ExpressionCode;
 
-            // Computed in pass 1
-            //
-            DataSize operandSize_;
-        };
+            const Insn *begin() const;
+            const Insn *end() const;
 
-        class OrgNode : public Node
-        {
-        public:
-            OrgNode(ExpressionPtr locExpr);
-
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual int length() const override;
-            virtual std::string toString() override;
-
-        private:
-            ExpressionPtr locExpr_;
-            int computedLoc_;
+            const ExpressionCode *code_;
+            uint32_t offset_;
+            uint32_t length_;
+            uint16_t depth_;    // evaluation stack entries needed
+            bool parenthesized_;
         };
 
-        class SetNode : public Node
+        // The code for all the expressions in one assembly.
+        //
+        class ExpressionCode
         {
         public:
-            SetNode(const std::string &symbol, ExpressionPtr value);
+            void clear();
+            uint32_t mark() const;
+            void rewind(uint32_t mark);
 
-            virtual void pass1(Pass1 &pass1) override;
-            virtual void pass2(Pass2 &pass2) override;
-            virtual int length() const override;
-            virtual std::string toString() override;
+            Expression constant(int value);
+            Expression symbol(int symbol);
+            Expression location();
+            Expression unary(Operator op, const Expression &operand);
+            Expression binary(Operator op, const Expression &left, const Expression &right);
+            Expression parenthesized(const Expression &expr);
+
+            const Insn *at(uint32_t offset) const;
 
         private:
-            std::string symbol_;
-            ExpressionPtr value_;
+            Expression leaf(InsnType type, int operand);
+            Expression fold(const Expression &expr, int value);
+
+            std::vector<Insn> code_;
         };
 
         enum class IndexReg
@@ -236,125 +227,186 @@ namespace yas6502
             }
         }
 
-        enum class Operator
+        class Address
         {
-            Add,
-            Sub,
-            Mul,
-            Div,
-            Mod,
-            Neg,
-            LShift,
-            RShift,
-            And,
-            Or,
-            Xor,
-            BitNeg
+        public:
+            Address();
+            Address(AddrMode mode, const Expression &address);
+
+            void format(ListingBuffer &out, const SymbolTable &symtab) const;
+
+            AddrMode mode() const;
+            const Expression *addressExpr() const;
+
+        private:
+            AddrMode mode_;
+            Expression address_;
         };
 
-        class ExprResult
+        class Node
         {
         public:
-            ExprResult(int value);
-            ExprResult(std::set<std::string> &&undefined);
+            Node();
 
-            bool defined() const;
-            int value() const;
-            const std::set<std::string> &undefinedSymbols() const;
+            void setLine(int line);
+            void setLoc(int loc);
+            void setNextLoc(int loc);
+            void setLabel(int label);
+            void setComment(const Text &comment);
 
-        private:
-            int value_;
-            std::set<std::string> undefinedSymbols_;
+            int line() const;
+            int loc() const;
+            virtual int length() const;
+            virtual bool fixesLocation() const;
+            virtual void attributes(ListingBuffer &out) const;
+
+            void list(ListingBuffer &out, const Image &image, const SymbolTable &symtab) const;
+
+            virtual void pass1(Pass1 &pass1);
+            virtual void pass2(Pass2 &pass2);
+
+        protected:
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const = 0;
+
+            int line_;
+            int loc_;
+            int nextLoc_;  // the location of the following instruction
+            int label_;
+            Text comment_;
         };
 
-        class Expression
+        class NoopNode : public Node
         {
         public:
-            Expression();
-            virtual ~Expression();
 
-            bool parenthesized() const;
-            void setParenthesized();
+        protected:
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
+        };
 
-            virtual std::string str() = 0;
-            virtual ExprResult eval(Pass &pass) = 0;
+        enum class DataSize
+        {
+            Byte,
+            Word,
+        };
 
-        private:
-            bool parenthesized_;
+        struct DataElement
+        {
+            Expression count;
+            Expression value;
+
+            DataElement();
+            DataElement(const Expression &count, const Expression &value);
         };
 
-        class Address
+        // A data list made of nothing but plain constants that fit is
+        // packed into the bytes it emits, and keeps no expressions.
+        //
+        class DataNode : public Node
         {
         public:
-            Address(AddrMode mode, ExpressionPtr address);
+            DataNode(DataSize size, const Span<const DataElement> &data);
+            DataNode(DataSize size, const Span<const uint8_t> &packed);
 
-            std::string str();
-
-            AddrMode mode() const;
-            Expression *addressExpr() const;
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
 
         private:
-            AddrMode mode_;
-            ExpressionPtr address_;
+            DataSize size_;
+            Span<const DataElement> data_;
+            Span<const uint8_t> packed_;
         };
 
-        
-        class UnaryOp : public Expression
+        Node *makeDataNode(Arena &arena, ExpressionCode &code, uint32_t codeMark, DataSize size, const std::vector<DataElement> &data);
+
+        class SpaceNode : public Node
         {
         public:
-            UnaryOp(Operator op, ExpressionPtr operand);
+            SpaceNode(DataSize size, const Expression &count);
 
-            virtual std::string str() override;
-            virtual ExprResult eval(Pass &pass) override;
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual int length() const override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
 
         private:
-            Operator op_;
-            ExpressionPtr operand_;
+            Expression count_;
+            DataSize size_;
         };
 
-        class BinaryOp : public Expression
+        class StringNode : public Node
         {
         public:
-            BinaryOp(Operator op, ExpressionPtr left, ExpressionPtr right);
+            StringNode(const Text &str, bool nulTerminate);
 
-            virtual std::string str() override;
-            virtual ExprResult eval(Pass &pass) override;
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
 
         private:
-            Operator op_;
-            ExpressionPtr left_;
-            ExpressionPtr right_;
+            Text str_;
+            bool nulTerminate_;
         };
-        
-        class SymbolExpression : public Expression
+
+        class InstructionNode : public Node
         {
         public:
-            SymbolExpression(const std::string &symbol);
+            InstructionNode(opcodes::Mnemonic mnemonic, const Text &spelling, const Address &address);
 
-            virtual std::string str() override;
-            virtual ExprResult eval(Pass &pass) override;
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
+
+            virtual void attributes(ListingBuffer &out) const override;
 
         private:
-            const std::string symbol_;
+            void cacheOperand(Pass1 &pass1);
+            int operandValue(Pass2 &pass2) const;
+
+            Text opcode_;
+            const opcodes::Instruction &instruction_;
+            Address address_;
+            int clockCycles_;
+            bool hasExtraClockCycles_;
+            bool undocumented_;
+            bool unstable_;
+
+            // Computed in pass 1
+            //
+            DataSize operandSize_;
+            bool operandKnown_;     // the operand was fully defined
+            int operand_;           // and this is its value
         };
 
-        class ConstantExpression : public Expression
+        class OrgNode : public Node
         {
         public:
-            ConstantExpression(int value);
+            OrgNode(const Expression &locExpr);
 
-            virtual std::string str() override;
-            virtual ExprResult eval(Pass &pass) override;
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual int length() const override;
+            virtual bool fixesLocation() const override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
 
         private:
-            int value_;
+            Expression locExpr_;
+            int computedLoc_;
         };
 
-        class LocationExpression : public Expression
+        class SetNode : public Node
         {
         public:
-            virtual std::string str() override;
-            virtual ExprResult eval(Pass &pass) override;
+            SetNode(int symbol, const Expression &value);
+
+            virtual void pass1(Pass1 &pass1) override;
+            virtual void pass2(Pass2 &pass2) override;
+            virtual int length() const override;
+            virtual void format(ListingBuffer &out, const SymbolTable &symtab) const override;
+
+        private:
+            int symbol_;
+            Expression value_;
         };
     }
 }
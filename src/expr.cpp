@@ -28,17 +28,18 @@
 #include <algorithm>
 #include <cassert>
 #include <stdexcept>
+#include <vector>
 
 using std::set;
 using std::string;
 
-using yas6502::ast::BinaryOp;
-using yas6502::ast::ConstantExpression;
-using yas6502::ast::SymbolExpression;
-using yas6502::ast::LocationExpression;
+using std::vector;
+
+using yas6502::ast::Expression;
 using yas6502::ast::ExprResult;
+using yas6502::ast::Insn;
+using yas6502::ast::InsnType;
 using yas6502::ast::Operator;
-using yas6502::ast::UnaryOp;
 
 namespace yas6502
 {
@@ -47,24 +48,64 @@ namespace yas6502
      */
     ExprResult::ExprResult(int value)
         : value_(value)
+        , defined_(true)
+        , overflow_(false)
+        , undefinedCount_(0)
     {
     }
 
     /**
-     * Construct an undefined expression result
+     * Construct the result of referencing an undefined symbol
      */
-    ExprResult::ExprResult(set<string> &&undefinedSymbols)
-        : value_(1)
-        , undefinedSymbols_(std::move(undefinedSymbols))
+    ExprResult ExprResult::undefinedSymbol(int symbol)
     {
+        ExprResult result{ 1 };
+        result.defined_ = false;
+        result.undefined_[result.undefinedCount_++] = symbol;
+        return result;
+    }
+
+    /**
+     * Merge in the undefined symbols of another result, which makes
+     * this result undefined if `other' is. If there are more distinct
+     * symbols than we have room for, just remember that some were lost.
+     */
+    void ExprResult::addUndefined(const ExprResult &other)
+    {
+        if (other.defined_) {
+            return;
+        }
+
+        if (defined_) {
+            *this = other;
+            return;
+        }
+
+        overflow_ = overflow_ || other.overflow_;
+
+        for (int i = 0; i < other.undefinedCount_; i++) {
+            int symbol = other.undefined_[i];
+            int *end = undefined_ + undefinedCount_;
+
+            if (std::find(undefined_, end, symbol) != end) {
+                continue;
+            }
+
+            if (undefinedCount_ == MAX_UNDEFINED) {
+                overflow_ = true;
+                break;
+            }
+
+            undefined_[undefinedCount_++] = symbol;
+        }
     }
-    
+
     /**
      * An expression result is defined if it has no undefined symbols.
      */
     bool ExprResult::defined() const
     {
-        return undefinedSymbols_.empty();
+        return defined_;
     }
 
     /**
@@ -76,135 +117,205 @@ namespace yas6502
     }
 
     /**
-     * The undefined symbols encountered while evaluating an expression
+     * The names of the undefined symbols encountered while evaluating
+     * `expr', which must be the expression that produced this result. This
+     * is only for error messages.
      */
-    const set<string> &ExprResult::undefinedSymbols() const
+    set<string> ExprResult::undefinedSymbols(const SymbolTable &symtab, const Expression &expr) const
     {
-        return undefinedSymbols_;
+        set<string> names{};
+
+        if (overflow_) {
+            expr.collectUndefined(symtab, names);
+            return names;
+        }
+
+        for (int i = 0; i < undefinedCount_; i++) {
+            names.insert(symtab.spelling(undefined_[i]));
+        }
+
+        return names;
     }
 
     /**
-     * Evaluate a unary operation
+     * Apply a unary operator to a value
      */
-    ExprResult UnaryOp::eval(Pass &pass)
+    int ast::applyUnary(Operator op, int operand)
     {
-        ExprResult op = operand_->eval(pass);
-        if (!op.defined()) {
-            return op;
-        }
-
-        switch (op_) {
+        switch (op) {
         case Operator::Neg:
-            op = ExprResult{ -op.value() };
-            break;
+            return -operand;
 
         case Operator::BitNeg:
-            op = ExprResult{ ~op.value() };
+            return ~operand;
+
+        default:
             break;
         }
 
-        return op;
+        return operand;
     }
 
     /**
-     * Evaluate a binary operation
+     * Apply a binary operator to two values
      */
-    ExprResult BinaryOp::eval(Pass &pass)
+    int ast::applyBinary(Operator op, int left, int right)
     {
-        ExprResult left = left_->eval(pass);
-        ExprResult right = right_->eval(pass);
-        if (!left.defined() || !right.defined()) {
-            set<string> undefs{};
-
-            for (string undef : left.undefinedSymbols()) {
-                undefs.insert(undef);
-            }
-
-            for (string undef : right.undefinedSymbols()) {
-                undefs.insert(undef);
-            }
-            
-            return ExprResult{ std::move(undefs) };
-        }
-
-        switch (op_) {
+        switch (op) {
         case Operator::Add:
-            left = ExprResult{ left.value() + right.value() };
-            break;
+            return left + right;
 
         case Operator::Sub:
-            left = ExprResult{ left.value() - right.value() };
-            break;
+            return left - right;
 
         case Operator::Mul:
-            left = ExprResult{ left.value() * right.value() };
-            break;
+            return left * right;
 
         case Operator::Div:
-            if (right.value() == 0) {
+            if (right == 0) {
                 throw Error{ "Divide by zero." };
             }
-            left = ExprResult{ left.value() / right.value() };
-            break;
+            return left / right;
 
         case Operator::Mod:
-            if (right.value() == 0) {
+            if (right == 0) {
                 throw Error{ "Divide by zero." };
             }
-            left = ExprResult{ left.value() % right.value() };
-            break;
+            return left % right;
 
         case Operator::LShift:
-            left = ExprResult{ left.value() << right.value() };
-            break;
+            return left << right;
 
         case Operator::RShift:
-            left = ExprResult{ left.value() >> right.value() };
-            break;
+            return left >> right;
 
         case Operator::And:
-            left = ExprResult{ left.value() & right.value() };
-            break;
+            return left & right;
 
         case Operator::Or:
-            left = ExprResult{ left.value() | right.value() };
-            break;
+            return left | right;
 
         case Operator::Xor:
-            left = ExprResult{ left.value() ^ right.value() };
+            return left ^ right;
+
+        default:
             break;
         }
 
         return left;
     }
 
+    namespace
+    {
+        /**
+         * Apply a unary operator to the top of the stack
+         */
+        void unaryOp(Operator op, ExprResult &operand)
+        {
+            if (operand.defined()) {
+                operand = ExprResult{ ast::applyUnary(op, operand.value()) };
+            }
+        }
+
+        /**
+         * Apply a binary operator to the top two stack entries,
+         * leaving the result in `left'
+         */
+        void binaryOp(Operator op, ExprResult &left, const ExprResult &right)
+        {
+            if (!left.defined() || !right.defined()) {
+                left.addUndefined(right);
+                return;
+            }
+
+            left = ExprResult{ ast::applyBinary(op, left.value(), right.value()) };
+        }
+
+        /**
+         * Run expression code on the given stack, which must be deep
+         * enough. The result is left at the bottom of the stack.
+         */
+        ExprResult run(const Insn *insn, const Insn *end, Pass &pass, ExprResult *stack)
+        {
+            const SymbolTable &symtab = pass.symtab();
+            ExprResult *top = stack;
+
+            for (; insn != end; ++insn) {
+                switch (insn->type) {
+                case InsnType::Constant:
+                    *top++ = ExprResult{ insn->operand };
+                    break;
+
+                case InsnType::Symbol:
+                    {
+                        Symbol sym = symtab.lookup(insn->operand);
+                        *top++ = sym.defined ? ExprResult{ sym.value } : ExprResult::undefinedSymbol(insn->operand);
+                    }
+                    break;
+
+                case InsnType::Location:
+                    *top++ = ExprResult{ pass.loc() };
+                    break;
+
+                case InsnType::Unary:
+                    unaryOp(insn->op, top[-1]);
+                    break;
+
+                case InsnType::Binary:
+                    --top;
+                    binaryOp(insn->op, top[-1], *top);
+                    break;
+
+                case InsnType::Folded:
+                    *top++ = ExprResult{ insn->operand };
+                    insn += insn->skip;
+                    break;
+                }
+            }
+
+            return stack[0];
+        }
+    }
+
     /**
-     * Evaluate a symbol expression
+     * Evaluate an expression. Most expressions are shallow enough to
+     * evaluate with a stack on the machine stack.
      */
-    ExprResult SymbolExpression::eval(Pass &pass)
+    ExprResult Expression::eval(Pass &pass) const
     {
-        Symbol sym = pass.symtab().lookup(symbol_);
-        if (!sym.defined) {
-            set<string> undefs{ symbol_ };
-            return ExprResult{ std::move(undefs) };
+        const int LOCAL_STACK = 16;
+
+        if (depth_ <= LOCAL_STACK) {
+            ExprResult stack[LOCAL_STACK];
+            return run(begin(), end(), pass, stack);
         }
-            
-        return ExprResult{ sym.value };
+
+        vector<ExprResult> stack(depth_);
+        return run(begin(), end(), pass, stack.data());
     }
 
     /**
-     * Evaluate a constant expression
+     * Collect the names of the undefined symbols in an expression.
      */
-    ExprResult ConstantExpression::eval(Pass &pass)
+    void Expression::collectUndefined(const SymbolTable &symtab, set<string> &names) const
     {
-        return ExprResult{ value_ };
+        for (const Insn *insn = begin(); insn != end(); ++insn) {
+            if (insn->type == InsnType::Symbol && !symtab.lookup(insn->operand).defined) {
+                names.insert(symtab.spelling(insn->operand));
+            }
+        }
     }
 
-    /** 
-     * The current value of the location counter
+    /**
+     * Return true if the expression refers to the location counter.
      */
-    ExprResult LocationExpression::eval(Pass &pass)
+    bool Expression::usesLocation() const
     {
-        return ExprResult{ pass.loc() };
+        for (const Insn *insn = begin(); insn != end(); ++insn) {
+            if (insn->type == InsnType::Location) {
+                return true;
+            }
+        }
+        return false;
     }
 }
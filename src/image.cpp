@@ -0,0 +1,206 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "image.h"
+
+#include <algorithm>
+
+namespace
+{
+    /**
+     * Return the index of the lowest set bit in a non-zero word.
+     */
+    int lowestBit(uint64_t word)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int bit = 0;
+        while ((word & 1) == 0) {
+            word >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+}
+
+namespace yas6502
+{
+    /**
+     * Construct an empty image
+     */
+    Image::Image()
+    {
+        clear();
+    }
+
+    /**
+     * Mark every byte as empty. The bytes themselves don't need to
+     * be touched.
+     */
+    void Image::clear()
+    {
+        std::fill(coverage_, coverage_ + WORDS, 0);
+    }
+
+    /**
+     * Store `length' bytes from `data' starting at `addr'. The whole 
+     * range must be in memory.
+     */
+    void Image::set(int addr, const uint8_t *data, int length)
+    {
+        std::copy_n(data, length, bytes_ + addr);
+        cover(addr, length);
+    }
+
+    /**
+     * Store `length' bytes starting at `addr', repeating the bytes of
+     * `pattern'. The whole range must be in memory.
+     */
+    void Image::fill(int addr, const uint8_t *pattern, int patternLength, int length)
+    {
+        if (patternLength == 1) {
+            std::fill_n(bytes_ + addr, length, pattern[0]);
+        } else {
+            for (int i = 0; i < length; i++) {
+                bytes_[addr + i] = pattern[i % patternLength];
+            }
+        }
+        cover(addr, length);
+    }
+
+    /**
+     * Mark `length' bytes starting at `addr' as stored, a word of the
+     * bitmap at a time.
+     */
+    void Image::cover(int addr, int length)
+    {
+        int end = addr + length;
+        while (addr < end) {
+            int bit = addr % WORD_BITS;
+            int bits = std::min(WORD_BITS - bit, end - addr);
+
+            uint64_t mask = (bits == WORD_BITS) ? ~uint64_t{ 0 } : ((uint64_t{ 1 } << bits) - 1) << bit;
+            coverage_[addr / WORD_BITS] |= mask;
+            addr += bits;
+        }
+    }
+
+    /**
+     * Store every byte that has been stored in `other', replacing 
+     * what is here.
+     */
+    void Image::merge(const Image &other)
+    {
+        for (int word = 0; word < WORDS; word++) {
+            uint64_t bits = other.coverage_[word];
+            int base = word * WORD_BITS;
+
+            if (bits == ~uint64_t{ 0 }) {
+                std::copy_n(other.bytes_ + base, WORD_BITS, bytes_ + base);
+            } else {
+                for (; bits != 0; bits &= bits - 1) {
+                    int addr = base + lowestBit(bits);
+                    bytes_[addr] = other.bytes_[addr];
+                }
+            }
+
+            coverage_[word] |= other.coverage_[word];
+        }
+    }
+
+    /**
+     * Return the raw bytes. Bytes that were never stored are undefined.
+     */
+    const uint8_t *Image::bytes() const
+    {
+        return bytes_;
+    }
+
+    /**
+     * Find the next run of stored bytes at or after `from'. On success,
+     * the run is [start, end).
+     */
+    bool Image::nextRun(int from, int &start, int &end) const
+    {
+        start = scan(from, true);
+        if (start == SIZE) {
+            return false;
+        }
+
+        end = scan(start, false);
+        return true;
+    }
+
+    /**
+     * Find the lowest and just past the highest stored addresses.
+     * Returns false if the image is empty.
+     */
+    bool Image::bounds(int &start, int &end) const
+    {
+        start = scan(0, true);
+        if (start == SIZE) {
+            return false;
+        }
+
+        int word = WORDS - 1;
+        while (coverage_[word] == 0) {
+            word--;
+        }
+
+        uint64_t bits = coverage_[word];
+        int high = WORD_BITS - 1;
+        while (((bits >> high) & 1) == 0) {
+            high--;
+        }
+
+        end = word * WORD_BITS + high + 1;
+        return true;
+    }
+
+    /**
+     * Return the first address at or after `from' which is stored
+     * (if `populated') or empty (if not), or SIZE if there is none.
+     */
+    int Image::scan(int from, bool populated) const
+    {
+        if (from >= SIZE) {
+            return SIZE;
+        }
+
+        int word = from / WORD_BITS;
+        uint64_t invert = populated ? 0 : ~uint64_t{ 0 };
+
+        // Mask off the bits below `from' in the first word.
+        //
+        uint64_t bits = (coverage_[word] ^ invert) & (~uint64_t{ 0 } << (from % WORD_BITS));
+
+        while (bits == 0) {
+            if (++word == WORDS) {
+                return SIZE;
+            }
+            bits = coverage_[word] ^ invert;
+        }
+
+        return word * WORD_BITS + lowestBit(bits);
+    }
+}
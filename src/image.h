@@ -0,0 +1,95 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#ifndef IMAGE_H_
+#define IMAGE_H_
+
+#include <cstdint>
+
+namespace yas6502
+{
+    // The assembled image of all of memory. The address space of a 16-bit
+    // processor is so small that it makes sense to just keep an image of
+    // all of it rather than build individual OMF records. A bitmap records
+    // which bytes have been written, so that the object writers can find
+    // populated runs a 64-bit word at a time.
+    //
+    class Image
+    {
+    public:
+        static const int SIZE = 0x10000;
+
+        Image();
+
+        void clear();
+        void set(int addr, uint8_t byte);
+        void set(int addr, const uint8_t *data, int length);
+        void fill(int addr, const uint8_t *pattern, int patternLength, int length);
+        void merge(const Image &other);
+
+        bool has(int addr) const;
+        int operator[](int addr) const;
+        const uint8_t *bytes() const;
+
+        bool nextRun(int from, int &start, int &end) const;
+        bool bounds(int &start, int &end) const;
+
+    private:
+        static const int WORD_BITS = 64;
+        static const int WORDS = SIZE / WORD_BITS;
+
+        int scan(int from, bool populated) const;
+        void cover(int addr, int length);
+
+        uint8_t bytes_[SIZE];
+        uint64_t coverage_[WORDS];
+    };
+
+    /**
+     * Store a byte. `addr' must be in range.
+     */
+    inline void Image::set(int addr, uint8_t byte)
+    {
+        bytes_[addr] = byte;
+        coverage_[addr / WORD_BITS] |= uint64_t{ 1 } << (addr % WORD_BITS);
+    }
+
+    /**
+     * Check if a byte has been stored at `addr'.
+     */
+    inline bool Image::has(int addr) const
+    {
+        if (addr < 0 || addr >= SIZE) {
+            return false;
+        }
+        return (coverage_[addr / WORD_BITS] >> (addr % WORD_BITS)) & 1;
+    }
+
+    /**
+     * Return the byte at `addr', or -1 if nothing was stored there.
+     */
+    inline int Image::operator[](int addr) const
+    {
+        return has(addr) ? bytes_[addr] : -1;
+    }
+}
+
+#endif
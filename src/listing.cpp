@@ -19,294 +19,445 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *
  **/
+#include "listing.h"
+
 #include "ast.h"
+#include "symtab.h"
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <string>
-#include <vector>
 
 using std::string;
-using std::vector;
-
-using ss = std::stringstream;
 
 namespace yas6502
 {
+    namespace
+    {
+        const char *HEX_DIGITS = "0123456789ABCDEF";
+    }
+
+    /**
+     * Constructor for a buffer that collects text.
+     */
+    ListingBuffer::ListingBuffer()
+        : out_(nullptr)
+    {
+        buffer_.reserve(FLUSH_SIZE + 1024);
+    }
+
+    /**
+     * Constructor. Text is written to `out' as the buffer fills.
+     */
+    ListingBuffer::ListingBuffer(std::ostream &out)
+        : out_(&out)
+    {
+        buffer_.reserve(FLUSH_SIZE + 1024);
+    }
+
+    /**
+     * Append a NUL terminated string.
+     */
+    void ListingBuffer::put(const char *text)
+    {
+        buffer_.append(text, strlen(text));
+    }
+
+    /**
+     * Append a string.
+     */
+    void ListingBuffer::put(const string &text)
+    {
+        buffer_.append(text);
+    }
+
+    /**
+     * Append text from the arena.
+     */
+    void ListingBuffer::put(const Text &text)
+    {
+        buffer_.append(text.data, text.length);
+    }
+
+    /**
+     * Append a decimal number, right aligned in a field of `width'
+     * characters and padded with spaces.
+     */
+    void ListingBuffer::decimal(int value, int width)
+    {
+        char digits[16];
+        char *end = digits + sizeof(digits);
+        char *p = end;
+
+        unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : value;
+        do {
+            *--p = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0) {
+            *--p = '-';
+        }
+
+        if (end - p < width) {
+            buffer_.append(width - (end - p), ' ');
+        }
+        buffer_.append(p, end - p);
+    }
+
+    /**
+     * Append a hex number, zero filled to `width' digits. Like an
+     * iostream, negative values are shown as unsigned.
+     */
+    void ListingBuffer::hex(int value, int width)
+    {
+        char digits[16];
+        char *end = digits + sizeof(digits);
+        char *p = end;
+
+        unsigned bits = value;
+        do {
+            *--p = HEX_DIGITS[bits & 0x0F];
+            bits >>= 4;
+        } while (bits != 0);
+
+        if (end - p < width) {
+            buffer_.append(width - (end - p), '0');
+        }
+        buffer_.append(p, end - p);
+    }
+
+    /**
+     * Return a mark at the end of the text, for padding the text
+     * appended after it into a field. A mark is only good until the
+     * end of the line.
+     */
+    size_t ListingBuffer::mark() const
+    {
+        return buffer_.size();
+    }
+
+    /**
+     * Right align the text appended since `mark' in a field of
+     * `width' characters.
+     */
+    void ListingBuffer::padLeft(size_t mark, size_t width)
+    {
+        size_t length = buffer_.size() - mark;
+        if (length < width) {
+            buffer_.insert(mark, width - length, ' ');
+        }
+    }
+
+    /**
+     * Left align the text appended since `mark' in a field of
+     * `width' characters.
+     */
+    void ListingBuffer::padRight(size_t mark, size_t width)
+    {
+        size_t length = buffer_.size() - mark;
+        if (length < width) {
+            buffer_.append(width - length, ' ');
+        }
+    }
+
+    /**
+     * End the current line, and write out the buffer if it's full.
+     */
+    void ListingBuffer::newline()
+    {
+        buffer_.push_back('\n');
+        if (out_ != nullptr && buffer_.size() >= FLUSH_SIZE) {
+            flush();
+        }
+    }
+
+    /**
+     * Append all the text collected in `other', which should end
+     * with a complete line.
+     */
+    void ListingBuffer::append(const ListingBuffer &other)
+    {
+        if (out_ == nullptr) {
+            buffer_.append(other.buffer_);
+            return;
+        }
+
+        flush();
+        out_->write(other.buffer_.data(), other.buffer_.size());
+    }
+
+    /**
+     * Write out everything in the buffer. A buffer without a stream
+     * keeps its text.
+     */
+    void ListingBuffer::flush()
+    {
+        if (out_ == nullptr) {
+            return;
+        }
+
+        out_->write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
     namespace ast 
     {
         /**
-         * Return default string for node attributes 
+         * Nodes have no attributes by default.
          */
-        string Node::attributes() const
+        void Node::attributes(ListingBuffer &out) const
         {
-            return "";
         }
 
         /**
-         * Convert this line to a string. This is the public 
-         * interface that handles the fields every node has, and
-         * toString() is overridden by each subclass to convert
-         * their data.
+         * List this statement. This is the public interface that 
+         * handles the fields every node has, and format() is 
+         * overridden by each subclass to list their data. Bytes
+         * that don't fit on the first line go on more lines after it.
          */
-        vector<string> Node::str(const Image &image)
+        void Node::list(ListingBuffer &out, const Image &image, const SymbolTable &symtab) const
         {
-            vector<string> lines{};
-
-            ss line{};
-
-            line
-                << std::setw(5) << line_ << " "
-                << std::setw(4) << std::hex << std::setfill('0') << std::uppercase << loc_
-                << "  ";
+            out.decimal(line_, 5);
+            out.put(' ');
+            out.hex(loc_, 4);
+            out.put("  ");
 
             const int MAX_BYTES = 5;
             int bytes = std::min(MAX_BYTES, length());
 
             int i = 0;
             for (; i < bytes; i++) {
-                line << std::setw(2) << std::setfill('0') << std::hex << (int)image[loc_ + i] << " "; 
+                out.hex(image[loc_ + i], 2);
+                out.put(' ');
             }
 
             for (; i < MAX_BYTES; i++) {
-                line << "   ";
+                out.put("   ");
             }
 
-            line 
-                << std::setfill(' ')
-                << std::setw(8) << attributes()
-                << " ";
+            size_t mark = out.mark();
+            attributes(out);
+            out.padLeft(mark, 8);
+            out.put(' ');
 
-            if (!label_.empty()) {
-                line << std::setw(9) << std::left << (label_ + ":");
+            mark = out.mark();
+            if (label_ != NO_SYMBOL) {
+                out.put(symtab.spelling(label_));
+                out.put(':');
             } else {
-                line << std::setw(9) << " ";
+                out.put(' ');
             }
-           
-            line 
-                << "  "
-                << std::setw(20)
-                << std::left
-                << toString()
-                << comment_;
-
-            lines.push_back(line.str());
-
-            // If the statement emitted more bytes than we put in one line, add the rest
-            // as more lines
-            //
+            out.padRight(mark, 9);
+            out.put("  ");
+
+            mark = out.mark();
+            format(out, symtab);
+            out.padRight(mark, 20);
+            out.put(comment_);
+            out.newline();
+
             int bytesLeft = length() - bytes;
             int addr = loc_ + bytes;
 
             while (bytesLeft) {
                 int n = std::min(MAX_BYTES, bytesLeft);
 
-                ss line{};
-
-                line
-                    << std::uppercase
-                    << std::setw(5) << std::dec << std::setfill(' ') << line_ << " "
-                    << std::setw(4) << std::hex << std::setfill('0') << addr
-                    << "  "
-                    << std::hex << std::setfill('0');
+                out.decimal(line_, 5);
+                out.put(' ');
+                out.hex(addr, 4);
+                out.put("  ");
 
                 for (int i = 0; i < n; i++) {
-                    line 
-                        << std::setw(2) << (int)image[addr++] << " "; 
+                    out.hex(image[addr++], 2);
+                    out.put(' ');
                 }
 
                 bytesLeft -= n;
-                lines.push_back(line.str());
+                out.newline();
             }
-
-            return lines;
         }
 
         /**
          * Placeholder node with no operation
          */
-        string NoopNode::toString()
+        void NoopNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            return "";
         }
 
         /**
-         * Convert to string
+         * List the data 
          */
-        string DataNode::toString()
+        void DataNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line
-                << (size_ == DataSize::Byte ? "BYTE " : "WORD ");
+            out.put(size_ == DataSize::Byte ? "BYTE " : "WORD ");
+
+            if (packed_.data != nullptr) {
+                size_t width = (size_ == DataSize::Byte) ? 1 : 2;
+                for (size_t i = 0; i < packed_.size(); i += width) {
+                    int value = packed_[i];
+                    if (width == 2) {
+                        value |= packed_[i + 1] << 8;
+                    }
+
+                    if (i != 0) {
+                        out.put(", ");
+                    }
+                    out.put('$');
+                    out.hex(value, value < 0x0100 ? 2 : 4);
+                }
+                return;
+            }
 
             for (unsigned i = 0; i < data_.size(); i++) {
-                if (data_[i]->count != nullptr) {
-                    line 
-                        << "REP("
-                        << data_[i]->count->str()
-                        << ") "; 
+                if (!data_[i].count.empty()) {
+                    out.put("REP(");
+                    data_[i].count.format(out, symtab);
+                    out.put(") ");
                 }
-                line << data_[i]->value->str();
+                data_[i].value.format(out, symtab);
                 if (i < data_.size() - 1) {
-                    line << ", ";
+                    out.put(", ");
                 }
             }
-
-            return line.str();
         }
 
         /**
-         * Convert to string
+         * List the space reservation
          */
-        string SpaceNode::toString()
+        void SpaceNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line
-                << (size_ == DataSize::Byte ? "BYTES " : "WORDS ")
-                << count_->str();
-
-            return line.str();
+            out.put(size_ == DataSize::Byte ? "BYTES " : "WORDS ");
+            count_.format(out, symtab);
         }
 
         /*
-         * Convert string to string
+         * List the string, escaped as it would be in the source
          */
-        string StringNode::toString()
+        void StringNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line << (nulTerminate_ ? "ASCIIZ " : "ASCII  ");
+            out.put(nulTerminate_ ? "ASCIIZ " : "ASCII  ");
             
-            line << '"';
+            out.put('"');
             
             for (char s : str_) {
                 switch (s) {
                 case '"':
-                    line << "\\\"";
+                    out.put("\\\"");
                     continue;
 
                 case '\n':
-                    line << "\\n";
+                    out.put("\\n");
                     continue;
 
                 case '\r':
-                    line << "\\r";
+                    out.put("\\r");
                     continue;
                 }
 
-                line << s;
+                out.put(s);
             }
 
-
-            line << '"';
-
-            return line.str();
+            out.put('"');
         }
 
         /**
-         * Return the clock cycles description
+         * List the clock cycles description
          */
-        string InstructionNode::attributes() const
+        void InstructionNode::attributes(ListingBuffer &out) const
         {
-            ss text{};
-            text 
-                << clockCycles_
-                << (hasExtraClockCycles_ ? '+' : ' ')
-                << " "
-                << (undocumented_ ? 'U' : ' ')
-                << (unstable_ ? 'S' : ' ');
-
-            return text.str();
+            out.decimal(clockCycles_, 0);
+            out.put(hasExtraClockCycles_ ? '+' : ' ');
+            out.put(' ');
+            out.put(undocumented_ ? 'U' : ' ');
+            out.put(unstable_ ? 'S' : ' ');
         }
 
         /**
-         * Convert to string
+         * List the instruction
          */
-        string InstructionNode::toString()
+        void InstructionNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line << opcode_ << " " << address_->str();
-
-            return line.str(); 
+            out.put(opcode_);
+            out.put(' ');
+            address_.format(out, symtab);
         }
 
         /**
-         * Convert to string
+         * List the ORG
          */
-        string OrgNode::toString()
+        void OrgNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line << "ORG " << locExpr_->str();
-
-            return line.str(); 
+            out.put("ORG ");
+            locExpr_.format(out, symtab);
         }
 
         /**
-         * Convert to string
+         * List the SET
          */
-        string SetNode::toString()
+        void SetNode::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
-            line << "SET " << symbol_ << " = " << value_->str();
-
-            return line.str(); 
+            out.put("SET ");
+            out.put(symtab.spelling(symbol_));
+            out.put(" = ");
+            value_.format(out, symtab);
         }
 
         /**
-         * Convert an instruction operand to a string
+         * List an instruction operand
          */
-        string Address::str()
+        void Address::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            ss line{};
-
             switch (mode_) {
             case AddrMode::Implied:
                 break;
 
             case AddrMode::Immediate:
-                line << '#' << address_->str();
+                out.put('#');
+                address_.format(out, symtab);
                 break;
 
             case AddrMode::Accumulator:
-                line << "A";
+                out.put('A');
                 break;
 
             case AddrMode::Address:
-                line << address_->str();
+                address_.format(out, symtab);
                 break;
 
             case AddrMode::AddressX:
-                line << address_->str() << ",X";
+                address_.format(out, symtab);
+                out.put(",X");
                 break;
 
             case AddrMode::AddressY:
-                line << address_->str() << ",Y";
+                address_.format(out, symtab);
+                out.put(",Y");
                 break;
 
             case AddrMode::Indirect:
-                line << '[' << address_->str() << ']';
+                out.put('[');
+                address_.format(out, symtab);
+                out.put(']');
                 break;
 
             case AddrMode::IndirectX:
-                line << '[' << address_->str() << "],X";
+                out.put('[');
+                address_.format(out, symtab);
+                out.put("],X");
                 break;
 
             case AddrMode::IndirectY:
-                line << '[' << address_->str() << "],Y";
+                out.put('[');
+                address_.format(out, symtab);
+                out.put("],Y");
                 break;
             }
-
-            return line.str();
         }
 
         namespace
         {
-            string operatorToStr(Operator op)
+            const char *operatorToStr(Operator op)
             {
                 switch (op) {
                 case Operator::Add: return "+";
@@ -325,65 +476,91 @@ namespace yas6502
 
                 return "?";
             }
-        }
-
-        /**
-         * Convert a unary operator to a string. 
-         */
-        string UnaryOp::str()
-        {
-            ss line{};
-
-            line
-                << operatorToStr(op_)
-                << operand_->str();
-
-            return line.str();
-        }
-
-        /**
-         * Convert a binary operator to a string. 
-         */
-        string BinaryOp::str()
-        {
-            ss line{};
-
-            line
-                << left_->str()
-                << operatorToStr(op_)
-                << right_->str();
-
-            return line.str();
-        }
 
-        /**
-         * Convert a symbol expression to a string. 
-         */
-        string SymbolExpression::str()
-        {
-            return symbol_;
-        }
-
-        /**
-         * Convert a constant expression to a string. TODO this 
-         * should be in the same form as the original token.
-         */
-        string ConstantExpression::str()
-        {
-            ss line{};
-
-            int width = (value_ < 0x0100) ? 2 : 4;
+            /**
+             * Return the first instruction of the operand whose code
+             * ends with `last'. Folded instructions stand in front of
+             * code that is still all there, so they are passed over.
+             */
+            const Insn *operandStart(const Insn *last)
+            {
+                int needed = 1;
+                for (const Insn *insn = last; ; --insn) {
+                    switch (insn->type) {
+                    case InsnType::Folded:
+                        continue;
+
+                    case InsnType::Unary:
+                        break;
+
+                    case InsnType::Binary:
+                        needed++;
+                        break;
+
+                    default:
+                        needed--;
+                        break;
+                    }
+
+                    if (needed == 0) {
+                        return insn;
+                    }
+                }
+            }
 
-            line << '$' << std::hex << std::uppercase << std::setfill('0') << std::setw(width) << value_;
-            return line.str();
+            /**
+             * List the operand whose code ends with `last' in infix.
+             */
+            void formatOperand(ListingBuffer &out, const SymbolTable &symtab, const Insn *last)
+            {
+                switch (last->type) {
+                case InsnType::Constant:
+                    out.put('$');
+                    out.hex(last->operand, last->operand < 0x0100 ? 2 : 4);
+                    break;
+
+                case InsnType::Symbol:
+                    out.put(symtab.spelling(last->operand));
+                    break;
+
+                case InsnType::Location:
+                    out.put('.');
+                    break;
+
+                case InsnType::Unary:
+                    out.put(operatorToStr(last->op));
+                    formatOperand(out, symtab, last - 1);
+                    break;
+
+                case InsnType::Binary:
+                    {
+                        const Insn *left = operandStart(last - 1) - 1;
+                        while (left->type == InsnType::Folded) {
+                            --left;
+                        }
+
+                        formatOperand(out, symtab, left);
+                        out.put(operatorToStr(last->op));
+                        formatOperand(out, symtab, last - 1);
+                    }
+                    break;
+
+                case InsnType::Folded:
+                    break;
+                }
+            }
         }
 
         /**
-         * Convert the location counter symbol to a string
+         * List an expression. The code doesn't record parentheses, 
+         * so neither does the listing. Folded constants are shown as 
+         * written.
          */
-        string LocationExpression::str()
+        void Expression::format(ListingBuffer &out, const SymbolTable &symtab) const
         {
-            return ".";
+            if (length_ != 0) {
+                formatOperand(out, symtab, end() - 1);
+            }
         }
     }
 }
@@ -0,0 +1,80 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#ifndef LISTING_H_
+#define LISTING_H_
+
+#include "arena.h"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace yas6502
+{
+    // Output buffer for the listing file. Fields are formatted straight
+    // into the buffer, which is written out in large blocks between
+    // lines. The formatting follows the iostream manipulators the listing
+    // was originally written with: numbers are right aligned in their
+    // field, and hex is upper case and zero filled.
+    //
+    // A buffer without a stream just collects text, so parts of a
+    // listing can be made separately and appended in order.
+    //
+    class ListingBuffer
+    {
+    public:
+        ListingBuffer();
+        ListingBuffer(std::ostream &out);
+
+        void put(char ch);
+        void put(const char *text);
+        void put(const std::string &text);
+        void put(const Text &text);
+
+        void decimal(int value, int width);
+        void hex(int value, int width);
+
+        size_t mark() const;
+        void padLeft(size_t mark, size_t width);
+        void padRight(size_t mark, size_t width);
+
+        void newline();
+        void append(const ListingBuffer &other);
+        void flush();
+
+    private:
+        static const size_t FLUSH_SIZE = 64 * 1024;
+
+        std::ostream *out_;
+        std::string buffer_;
+    };
+
+    /**
+     * Append one character.
+     */
+    inline void ListingBuffer::put(char ch)
+    {
+        buffer_.push_back(ch);
+    }
+}
+
+#endif
@@ -23,17 +23,26 @@
 
 #include "ast.h"
 #include "except.h"
+#include "listing.h"
 #include "symtab.h"
 #include "utility.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 using std::cerr;
@@ -50,6 +59,7 @@ using ss = std::stringstream;
 
 using yas6502::Assembler;
 using yas6502::Image;
+using yas6502::ListingBuffer;
 using yas6502::Message;
 
 namespace ast = yas6502::ast;
@@ -61,39 +71,102 @@ namespace
         int value;
     };
 
+    struct Options {
+        bool listing = false;
+        string listingFile;
+        string objectFile;
+        bool binaryImage = false;
+        bool singlePass = false;
+        bool flexScanner = false;
+        int fileJobs = 1;
+    };
+
+    struct Result {
+        bool failed = false;
+        double milliseconds = 0.0;
+    };
+
+    // Upper case hex digit pairs for every byte value, for the
+    // object file writer.
+    //
+    struct HexTable {
+        char digits[256][2];
+    };
+
+    constexpr HexTable makeHexTable()
+    {
+        HexTable table{};
+        const char *hex = "0123456789ABCDEF";
+        for (int i = 0; i < 256; i++) {
+            table.digits[i][0] = hex[i >> 4];
+            table.digits[i][1] = hex[i & 0x0F];
+        }
+        return table;
+    }
+
+    constexpr HexTable HEX = makeHexTable();
+
+    // A source file in memory, followed by the two NUL bytes the
+    // scanner needs. Regular files are mapped copy on write with a
+    // page of zeroes reserved after them, so they're never copied;
+    // anything that can't be mapped is read instead.
+    //
+    class SourceFile
+    {
+    public:
+        SourceFile(const string &filename);
+        ~SourceFile();
+
+        SourceFile(const SourceFile &) = delete;
+        SourceFile &operator=(const SourceFile &) = delete;
+
+        char *data();
+        size_t length() const;
+
+    private:
+        bool map(int fd, size_t length);
+        void read(int fd, const string &filename);
+
+        char *mapping_;
+        size_t mappingLength_;
+        size_t length_;
+        vector<char> buffer_;
+    };
+
     void usage();
-    vector<char> readInputBuffer(const std::string &filename);
-    void showErrors(Assembler &asmb);
+    Result assembleFile(const string &sourceFile, const Options &opts, std::ostream &diag);
+    bool assembleBatch(const vector<string> &sourceFiles, const Options &opts, int jobs);
+    double elapsedMilliseconds(std::chrono::steady_clock::time_point start);
+    void showErrors(Assembler &asmb, std::ostream &diag);
     void writeObjectFile(const string &fn, const Image &image);
     void writeBinaryFile(const string &fn, const Image &image);
-    void writeListingFile(const string &fn, const Assembler &asmb);
-    void writeProgramLines(ofstream &out, const Assembler &asmb);
-    void writeErrors(ofstream &out, const Assembler &asmb);
-    void writeSymbolTable(ofstream &out, const Assembler &asmb);
-    void writeSymbols(ofstream &out, const std::vector<Symbol>& symbols, int maxLen, int perLine);
+    void writeListingFile(const string &fn, const Assembler &asmb, int jobs);
+    void writeProgramLines(ListingBuffer &out, const Assembler &asmb, int jobs);
+    void writeStatements(ListingBuffer &out, const Assembler &asmb, size_t begin, size_t end);
+    void writeErrors(ListingBuffer &out, const Assembler &asmb);
+    void writeSymbolTable(ListingBuffer &out, const Assembler &asmb);
+    void writeSymbols(ListingBuffer &out, const std::vector<Symbol>& symbols, int maxLen, int perLine);
 }
 
 int main(int argc, char *argv[])
 {
-    bool listing = false;
-    string listingFile = "";
-    string objectFile = "";
-    bool binaryImage = false;
+    Options opts{};
+    int jobs = 0;
     int ch;
 
-    while ((ch = getopt(argc, argv, "Ll:o:vb")) != -1) {
+    while ((ch = getopt(argc, argv, "Ll:o:vbsFj:")) != -1) {
         switch (ch) {
         case 'L':
-            listing = true;
+            opts.listing = true;
             break;
 
         case 'l':
-            listing = true;
-            listingFile = string{ optarg };
+            opts.listing = true;
+            opts.listingFile = string{ optarg };
             break;
 
         case 'o':
-            objectFile = string{ optarg };
+            opts.objectFile = string{ optarg };
             break;
 
         case 'v':
@@ -107,7 +180,22 @@ int main(int argc, char *argv[])
             return 0;
 
         case 'b':
-            binaryImage = true;
+            opts.binaryImage = true;
+            break;
+
+        case 's':
+            opts.singlePass = true;
+            break;
+
+        case 'F':
+            opts.flexScanner = true;
+            break;
+
+        case 'j':
+            jobs = atoi(optarg);
+            if (jobs < 1) {
+                usage();
+            }
             break;
 
         default:
@@ -119,46 +207,38 @@ int main(int argc, char *argv[])
         usage();
     }
 
-    string sourceFile{ argv[optind] };
-    if (listing && listingFile.empty()) {
-        listingFile = yas6502::replaceOrAppendExtension(sourceFile, "lst");
+    // A single pass assembly doesn't keep the program to list.
+    //
+    if (opts.singlePass && opts.listing) {
+        usage();
     }
 
-    if (objectFile.empty()) {
-        string ext = binaryImage ? "bin" : "o";
-        objectFile = yas6502::replaceOrAppendExtension(sourceFile, ext);
-    }
+    vector<string> sourceFiles{ argv + optind, argv + argc };
 
-    Assembler asmb{};
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
 
-    try {
-        vector<char> source = readInputBuffer(sourceFile);
+    // A single source file isn't a batch; all the threads go to its
+    // pass 2 and listing.
+    //
+    if (sourceFiles.size() == 1) {
+        opts.fileJobs = jobs;
+        return assembleFile(sourceFiles[0], opts, cerr).failed ? 1 : 0;
+    }
 
-        asmb.assemble(sourceFile, source);
-        
-        if (asmb.errors() || asmb.warnings()) {
-            showErrors(asmb);
-        }
+    // Explicit output names only make sense for a single source file.
+    //
+    if (!opts.listingFile.empty() || !opts.objectFile.empty()) {
+        usage();
+    }
 
-        unlink(objectFile.c_str());
-        if (asmb.errors() == 0) {
-            if (binaryImage) {
-                writeBinaryFile(objectFile, asmb.image());
-            } else {
-                writeObjectFile(objectFile, asmb.image());        
-            }
-        }
-        
-        if (listing) {
-            writeListingFile(listingFile, asmb);
-        }
+    // Threads left over from assembling files in parallel go to
+    // pass 2 and listings.
+    //
+    opts.fileJobs = std::max(1, jobs / static_cast<int>(sourceFiles.size()));
 
-        if (asmb.errors()) {
-            return 1;
-        }
-    } catch (yas6502::Error &ex) {
-        cerr << ex.message() << endl;
-    }
+    return assembleBatch(sourceFiles, opts, jobs) ? 0 : 1;
 }
 
 namespace 
@@ -169,15 +249,153 @@ namespace
     void usage()
     {
         cerr
-            << "yas6502: [-L] [-l listing-file] [-o object-file] source-file"
+            << "yas6502: [-L] [-l listing-file] [-o object-file] [-b] [-s] [-F] [-j jobs] source-file..."
             << endl;
         exit(1);
     }
-    
-    vector<char> readInputBuffer(const std::string &filename)
+
+    /**
+     * Assemble one source file and write its object file and, if asked
+     * for, its listing. Diagnostics go to `diag'.
+     */
+    Result assembleFile(const string &sourceFile, const Options &opts, std::ostream &diag)
     {
-        ifstream inp{ filename, std::ios::in | std::ios::binary };
-        if (!inp) {
+        auto start = std::chrono::steady_clock::now();
+        Result result{};
+
+        string listingFile = opts.listingFile;
+        if (opts.listing && listingFile.empty()) {
+            listingFile = yas6502::replaceOrAppendExtension(sourceFile, "lst");
+        }
+
+        string objectFile = opts.objectFile;
+        if (objectFile.empty()) {
+            string ext = opts.binaryImage ? "bin" : "o";
+            objectFile = yas6502::replaceOrAppendExtension(sourceFile, ext);
+        }
+
+        Assembler asmb{};
+        asmb.setJobs(opts.fileJobs);
+        asmb.setSinglePass(opts.singlePass);
+        asmb.setFlexScanner(opts.flexScanner);
+
+        try {
+            SourceFile source{ sourceFile };
+
+            asmb.assemble(sourceFile, source.data(), source.length());
+            
+            if (asmb.errors() || asmb.warnings()) {
+                showErrors(asmb, diag);
+            }
+
+            unlink(objectFile.c_str());
+            if (asmb.errors() == 0) {
+                if (opts.binaryImage) {
+                    writeBinaryFile(objectFile, asmb.image());
+                } else {
+                    writeObjectFile(objectFile, asmb.image());        
+                }
+            }
+            
+            if (opts.listing) {
+                writeListingFile(listingFile, asmb, opts.fileJobs);
+            }
+
+            result.failed = asmb.errors() != 0;
+        } catch (yas6502::Error &ex) {
+            diag << ex.message() << endl;
+            result.failed = true;
+        }
+
+        result.milliseconds = elapsedMilliseconds(start);
+        return result;
+    }
+
+    /**
+     * Assemble a batch of independent source files on a pool of `jobs'
+     * threads. Idle workers claim the next unassembled file from a shared
+     * cursor, so a few large sources don't hold up the rest of the batch.
+     * Each file's diagnostics are printed as one block; timings are printed
+     * to stderr in command line order once everything is done.
+     */
+    bool assembleBatch(const vector<string> &sourceFiles, const Options &opts, int jobs)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        vector<Result> results(sourceFiles.size());
+        std::atomic<size_t> next{ 0 };
+        std::mutex diagLock;
+
+        auto worker = [&]() {
+            for (size_t i = next++; i < sourceFiles.size(); i = next++) {
+                ss diag{};
+                results[i] = assembleFile(sourceFiles[i], opts, diag);
+
+                string text = diag.str();
+                if (!text.empty()) {
+                    std::lock_guard<std::mutex> lock{ diagLock };
+                    cerr << sourceFiles[i] << ":" << endl << text;
+                }
+            }
+        };
+
+        jobs = std::min(jobs, static_cast<int>(sourceFiles.size()));
+
+        vector<std::thread> threads{};
+        for (int i = 1; i < jobs; i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        double wall = elapsedMilliseconds(start);
+
+        bool ok = true;
+        double total = 0.0;
+
+        cerr << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < sourceFiles.size(); i++) {
+            cerr 
+                << std::setw(10) << results[i].milliseconds << " ms  " 
+                << sourceFiles[i] 
+                << (results[i].failed ? " (failed)" : "")
+                << endl;
+            total += results[i].milliseconds;
+            ok = ok && !results[i].failed;
+        }
+
+        cerr 
+            << sourceFiles.size() << " file(s) in "
+            << wall << " ms wall time ("
+            << total << " ms total) on "
+            << jobs << " thread(s)."
+            << endl;
+
+        return ok;
+    }
+
+    /**
+     * Return the number of milliseconds since `start'.
+     */
+    double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    /**
+     * Constructor. Map or read the source file.
+     */
+    SourceFile::SourceFile(const string &filename)
+        : mapping_(nullptr)
+        , mappingLength_(0)
+        , length_(0)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd == -1) {
             ss err{};
             err
                 << "Could not open source file `"
@@ -186,32 +404,120 @@ namespace
             throw yas6502::Error{ err.str() };
         }
 
-        inp.seekg(0, inp.end);
-        auto size = inp.tellg();
-        inp.seekg(0);
+        struct stat st;
+        bool mapped = 
+            fstat(fd, &st) == 0 &&
+            S_ISREG(st.st_mode) &&
+            st.st_size > 0 &&
+            map(fd, static_cast<size_t>(st.st_size));
 
-        vector<char> source{};
-        source.resize(size);
-        inp.read(source.data(), size);
-        if (!inp) {
-            ss err{};
-            err
-                << "Failed to read entire input file `"
-                << filename
-                << "'.";
-            throw yas6502::Error{ err.str() };
+        try {
+            if (!mapped) {
+                read(fd, filename);
+            }
+        } catch (...) {
+            close(fd);
+            throw;
         }
-        
-        return source;
+
+        close(fd);
+    }
+
+    /**
+     * Destructor
+     */
+    SourceFile::~SourceFile()
+    {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mappingLength_);
+        }
+    }
+
+    /**
+     * Return the source text. The scanner may write to it.
+     */
+    char *SourceFile::data()
+    {
+        return mapping_ != nullptr ? mapping_ : buffer_.data();
+    }
+
+    /**
+     * Return the length of the source, not counting the NULs after it.
+     */
+    size_t SourceFile::length() const
+    {
+        return length_;
+    }
+
+    /**
+     * Map `length' bytes of the file privately over the start of a
+     * zeroed region one page longer than the file's pages. The rest of 
+     * the file's last page, or else the extra page, supplies the NULs.
+     * Returns false if the file couldn't be mapped.
+     */
+    bool SourceFile::map(int fd, size_t length)
+    {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t pages = (length + page - 1) / page * page;
+        size_t total = pages + page;
+
+        void *region = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            return false;
+        }
+
+        void *file = mmap(region, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file == MAP_FAILED) {
+            munmap(region, total);
+            return false;
+        }
+
+        mapping_ = static_cast<char *>(region);
+        mappingLength_ = total;
+        length_ = length;
+        return true;
+    }
+
+    /**
+     * Read the whole file into a buffer, for files which can't be 
+     * mapped, such as pipes.
+     */
+    void SourceFile::read(int fd, const string &filename)
+    {
+        const size_t CHUNK = 64 * 1024;
+
+        for (;;) {
+            size_t used = buffer_.size();
+            buffer_.resize(used + CHUNK);
+
+            ssize_t got = ::read(fd, buffer_.data() + used, CHUNK);
+            if (got < 0) {
+                ss err{};
+                err
+                    << "Failed to read entire input file `"
+                    << filename
+                    << "'.";
+                throw yas6502::Error{ err.str() };
+            }
+
+            buffer_.resize(used + static_cast<size_t>(got));
+            if (got == 0) {
+                break;
+            }
+        }
+
+        length_ = buffer_.size();
+        buffer_.push_back(0);
+        buffer_.push_back(0);
     }
 
     /**
      * Print errors to stderr
      */
-    void showErrors(Assembler &asmb)
+    void showErrors(Assembler &asmb, std::ostream &diag)
     {
         for (Message message : asmb.messages()) {
-            cerr
+            diag
                 << std::setw(5) << message.line() << ": "
                 << (message.warning() ? "Warning" : "Error")
                 << ": "
@@ -219,7 +525,7 @@ namespace
                 << endl;
         }
 
-        cerr
+        diag
             << asmb.errors() << " error(s), "
             << asmb.warnings() << " warning(s)."
             << endl;
@@ -240,36 +546,61 @@ namespace
             throw yas6502::Error{ err.str() };
         }
         
-        int last = -1;
+        // The whole file is formatted into one buffer and written at
+        // once. Each byte takes at most three characters, and each run
+        // at most seven more for its address line.
+        //
+        int runs = 0;
+        int bytes = 0;
+        int start;
+        int end = 0;
+        while (image.nextRun(end, start, end)) {
+            runs++;
+            bytes += end - start;
+        }
+
+        vector<char> buffer(3 * bytes + 7 * runs);
+        char *p = buffer.data();
+        const uint8_t *data = image.bytes();
         int col = 0;
-        
-        out 
-            << std::hex 
-            << std::setfill('0')
-            << std::uppercase;
-
-        for (int addr = 0; addr < 0x10000; addr++) {
-            if (image[addr] == -1) {
-                continue;
-            }
 
-            if (addr != last + 1) {
+        // A run starting at address 0 gets no address line, since
+        // that is where loading starts. Note that the column is not
+        // reset by an address line.
+        //
+        end = 0;
+        while (image.nextRun(end, start, end)) {
+            if (start != 0) {
                 if (col != 0) {
-                    out << endl;
+                    *p++ = '\n';
                 }
-                out << '@' << std::setw(4) << addr << endl;
+                *p++ = '@';
+                std::copy_n(HEX.digits[start >> 8], 2, p);
+                std::copy_n(HEX.digits[start & 0xFF], 2, p + 2);
+                p += 4;
+                *p++ = '\n';
             } 
 
-            out << std::setw(2) << (int)image[addr];
-            col++;
-            if (col < 16) {
-                out << " ";
-            } else {
-                col = 0;
-                out << endl;
+            for (int addr = start; addr < end; addr++) {
+                std::copy_n(HEX.digits[data[addr]], 2, p);
+                p += 2;
+                if (++col < 16) {
+                    *p++ = ' ';
+                } else {
+                    col = 0;
+                    *p++ = '\n';
+                }
             }
+        }
 
-            last = addr;
+        out.write(buffer.data(), p - buffer.data());
+        if (!out) {
+            ss err{};
+            err
+                << "Error writing object file `"
+                << fn
+                << "'.";
+            throw yas6502::Error{ err.str() };
         }
     }
 
@@ -288,24 +619,20 @@ namespace
             throw yas6502::Error{ err.str() };
         }
 
-        int start = 0;
-        while (start < image.size() && image[start] == -1) {
-            start++;
-        }
-
-        int end = 0x10000;
-        while (end > 0 && image[end-1] == -1) {
-            end--;
-        }
-
-        if (start == end) {
+        int start;
+        int end;
+        if (!image.bounds(start, end)) {
             return;
         }
 
-        vector<uint8_t> bin{};
+        // Gaps between runs are filled with $FF
+        //
+        vector<uint8_t> bin(end - start, 0xFF);
 
-        for (int i = start; i < end; i++) {
-            bin.push_back(static_cast<uint8_t>(image[i]));
+        int runStart;
+        int runEnd = start;
+        while (image.nextRun(runEnd, runStart, runEnd)) {
+            std::copy(image.bytes() + runStart, image.bytes() + runEnd, bin.begin() + (runStart - start));
         }
 
         out.write(reinterpret_cast<char*>(bin.data()), end-start);
@@ -319,10 +646,10 @@ namespace
         }
     }
 
-    void writeListingFile(const string &fn, const Assembler &asmb)
+    void writeListingFile(const string &fn, const Assembler &asmb, int jobs)
     {
-        ofstream out{ fn };
-        if (!out) {
+        ofstream file{ fn };
+        if (!file) {
             ss err{};
             err
                 << "Could not open listing file `"
@@ -331,30 +658,69 @@ namespace
             throw yas6502::Error{ err.str() };
         }
 
-        writeProgramLines(out, asmb);
+        ListingBuffer out{ file };
+        writeProgramLines(out, asmb, jobs);
         writeErrors(out, asmb);
         writeSymbolTable(out, asmb);
+        out.flush();
     }
 
     /**
-     * Write out annotated program lines
+     * Write out annotated program lines. Once the image is finished,
+     * each statement's lines depend only on the statement itself, so a
+     * long program is split into chunks which are listed on `jobs'
+     * threads and appended in order.
      */
-    void writeProgramLines(ofstream &out, const Assembler &asmb)
+    void writeProgramLines(ListingBuffer &out, const Assembler &asmb, int jobs)
     {
-        const vector<unique_ptr<ast::Node>> &program{ asmb.program() };
+        const size_t MIN_CHUNK = 4096;
+
+        size_t statements = asmb.program().size();
+        size_t chunks = std::min(static_cast<size_t>(jobs), statements / MIN_CHUNK);
+
+        if (chunks <= 1) {
+            writeStatements(out, asmb, 0, statements);
+            return;
+        }
+
+        size_t perChunk = (statements + chunks - 1) / chunks;
+
+        vector<ListingBuffer> buffers(chunks);
+        vector<std::thread> threads{};
+        for (size_t i = 1; i < chunks; i++) {
+            size_t begin = i * perChunk;
+            size_t end = std::min(statements, begin + perChunk);
+            threads.emplace_back(writeStatements, std::ref(buffers[i]), std::cref(asmb), begin, end);
+        }
+
+        writeStatements(out, asmb, 0, perChunk);
+
+        for (size_t i = 1; i < chunks; i++) {
+            threads[i - 1].join();
+            out.append(buffers[i]);
+        }
+    }
+
+    /**
+     * Write out the annotated lines for statements `begin' up to `end'.
+     */
+    void writeStatements(ListingBuffer &out, const Assembler &asmb, size_t begin, size_t end)
+    {
+        const vector<ast::Node *> &program{ asmb.program() };
         const Image &image{ asmb.image() };
 
-        int last = 0;
-        for (const auto &stmt : program) {
+        int last = (begin == 0) ? 0 : program[begin - 1]->line();
+        for (size_t i = begin; i < end; i++) {
+            const ast::Node *stmt = program[i];
+
             // The assembler doesn't save blank lines with an empty AST node,
             // so put them back in for proper listing format.
             //
             for (; last < stmt->line() - 1; last++) {
-                out << std::setw(5) << last << endl;
-            }
-            for (string line : stmt->str(image)) {
-                out << line << endl;
+                out.decimal(last, 5);
+                out.newline();
             }
+            stmt->list(out, image, asmb.symtab());
             last = stmt->line();
         }
     }
@@ -362,18 +728,20 @@ namespace
     /**
      * Write out warnings and errors, if there are any
      */
-    void writeErrors(ofstream &out, const Assembler &asmb)
+    void writeErrors(ListingBuffer &out, const Assembler &asmb)
     {
         if (!asmb.messages().empty()) {
-            out << endl << "Errors and Warnings" << endl;
+            out.newline();
+            out.put("Errors and Warnings");
+            out.newline();
 
             for (const auto &msg : asmb.messages()) {
-                out
-                    << std::setw(5) << msg.line() << "  "
-                    << (msg.warning() ? "Warning" : "Error  ")
-                    << "  "
-                    << msg.message()
-                    << endl;
+                out.decimal(msg.line(), 5);
+                out.put("  ");
+                out.put(msg.warning() ? "Warning" : "Error  ");
+                out.put("  ");
+                out.put(msg.message());
+                out.newline();
             }
         }
     }
@@ -381,13 +749,13 @@ namespace
     /**
      * Write out the symbol table
      */
-    void writeSymbolTable(ofstream &out, const Assembler &asmb)
+    void writeSymbolTable(ListingBuffer &out, const Assembler &asmb)
     {
 
         vector<Symbol> symbols{};
 
         string::size_type maxLen = 0;
-        for (const auto &ent : asmb.symtab()) {
+        for (const auto &ent : asmb.symtab().byName()) {
             maxLen = std::max(maxLen, ent.first.length());
             symbols.push_back(Symbol{ ent.first, ent.second.value });
         }
@@ -396,7 +764,10 @@ namespace
         int perLine = COLUMNS / (maxLen + 8);
         perLine = std::max(1, perLine);
 
-        out << endl << "Symbol table by name" << endl << endl;
+        out.newline();
+        out.put("Symbol table by name");
+        out.newline();
+        out.newline();
         writeSymbols(out, symbols, maxLen, perLine);
 
         // now sort by value
@@ -404,32 +775,36 @@ namespace
             return left.value < right.value;
         });
 
-        out << endl << endl << "Symbol table by value" << endl << endl;
+        out.newline();
+        out.newline();
+        out.put("Symbol table by value");
+        out.newline();
+        out.newline();
         writeSymbols(out, symbols, maxLen, perLine);
     }
 
-    void writeSymbols(ofstream &out, const std::vector<Symbol>& symbols, int maxLen, int perLine)
+    void writeSymbols(ListingBuffer &out, const std::vector<Symbol>& symbols, int maxLen, int perLine)
     {
         int col = 0;
 
-        out << std::uppercase;
         for (const Symbol &sym : symbols) {
-            out 
-                << std::setfill(' ') << std::setw(maxLen) << sym.name
-                << " $"
-                << std::setfill('0') << std::hex << std::setw(4) << sym.value;
+            size_t mark = out.mark();
+            out.put(sym.name);
+            out.padLeft(mark, maxLen);
+            out.put(" $");
+            out.hex(sym.value, 4);
 
             ++col;
             if (col == perLine) {
-                out << endl;
+                out.newline();
                 col = 0;
             } else {
-                out << "  ";
+                out.put("  ");
             }
         }
 
         if (col) {
-            out << endl;
+            out.newline();
         }
     }
 }
@@ -21,7 +21,7 @@
  **/
 #include "opcodes.h"
 
-#include <cassert>
+#include <algorithm>
 
 using std::string;
 
@@ -29,143 +29,460 @@ namespace yas6502
 {
     namespace opcodes
     {
-        /** 
-         * Default construct an instruction encoding
-         */ 
-        Encoding::Encoding()
-            : exists_(false)
-            , opcode_(0)
-            , clocks_(0)
-            , undocumented_(false)
-            , unstable_(false)
-            , extraClocks_(false)
+        namespace
         {
-        }
+            /**
+             * What one opcode byte encodes. Bytes which are not assigned to
+             * any instruction have a mnemonic of None; their other fields
+             * are ignored.
+             */
+            struct OpcodeInfo 
+            {
+                Mnemonic mnemonic;
+                AddrMode mode;
+                unsigned clocks;
+                unsigned flags;
+            };
+
+            /**
+             * Every opcode byte the assembler knows about, in opcode order.
+             * This is the one place the instruction set is described; 
+             * everything else is derived from it at compile time.
+             */
+            constexpr OpcodeInfo OPCODES[256] = {
+            /* $00 */ { Mnemonic::BRK, AddrMode::Implied,     7, 0 },
+            /* $01 */ { Mnemonic::ORA, AddrMode::IndirectX,   6, 0 },
+            /* $02 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $03 */ { Mnemonic::SLO, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $04 */ { Mnemonic::NOP, AddrMode::ZeroPage,    3, Encoding::Undocumented },
+            /* $05 */ { Mnemonic::ORA, AddrMode::ZeroPage,    3, 0 },
+            /* $06 */ { Mnemonic::ASL, AddrMode::ZeroPage,    5, 0 },
+            /* $07 */ { Mnemonic::SLO, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $08 */ { Mnemonic::PHP, AddrMode::Implied,     3, 0 },
+            /* $09 */ { Mnemonic::ORA, AddrMode::Immediate,   2, 0 },
+            /* $0A */ { Mnemonic::ASL, AddrMode::Accumulator, 2, 0 },
+            /* $0B */ { Mnemonic::ANC, AddrMode::Immediate,   2, Encoding::Undocumented },
+            /* $0C */ { Mnemonic::NOP, AddrMode::Absolute,    4, Encoding::Undocumented },
+            /* $0D */ { Mnemonic::ORA, AddrMode::Absolute,    4, 0 },
+            /* $0E */ { Mnemonic::ASL, AddrMode::Absolute,    6, 0 },
+            /* $0F */ { Mnemonic::SLO, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $10 */ { Mnemonic::BPL, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $11 */ { Mnemonic::ORA, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $12 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $13 */ { Mnemonic::SLO, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $14 */ { Mnemonic::NOP, AddrMode::ZeroPageX,   4, Encoding::Undocumented },
+            /* $15 */ { Mnemonic::ORA, AddrMode::ZeroPageX,   4, 0 },
+            /* $16 */ { Mnemonic::ASL, AddrMode::ZeroPageX,   6, 0 },
+            /* $17 */ { Mnemonic::SLO, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $18 */ { Mnemonic::CLC, AddrMode::Implied,     2, 0 },
+            /* $19 */ { Mnemonic::ORA, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $1A */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $1B */ { Mnemonic::SLO, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $1C */ { Mnemonic::NOP, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks | Encoding::Undocumented },
+            /* $1D */ { Mnemonic::ORA, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $1E */ { Mnemonic::ASL, AddrMode::AbsoluteX,   7, 0 },
+            /* $1F */ { Mnemonic::SLO, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            /* $20 */ { Mnemonic::JSR, AddrMode::Absolute,    6, 0 },
+            /* $21 */ { Mnemonic::AND, AddrMode::IndirectX,   6, 0 },
+            /* $22 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $23 */ { Mnemonic::RLA, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $24 */ { Mnemonic::BIT, AddrMode::ZeroPage,    3, 0 },
+            /* $25 */ { Mnemonic::AND, AddrMode::ZeroPage,    3, 0 },
+            /* $26 */ { Mnemonic::ROL, AddrMode::ZeroPage,    5, 0 },
+            /* $27 */ { Mnemonic::RLA, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $28 */ { Mnemonic::PLP, AddrMode::Implied,     4, 0 },
+            /* $29 */ { Mnemonic::AND, AddrMode::Immediate,   2, 0 },
+            /* $2A */ { Mnemonic::ROL, AddrMode::Accumulator, 2, 0 },
+            /* $2B */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $2C */ { Mnemonic::BIT, AddrMode::Absolute,    4, 0 },
+            /* $2D */ { Mnemonic::AND, AddrMode::Absolute,    4, 0 },
+            /* $2E */ { Mnemonic::ROL, AddrMode::Absolute,    6, 0 },
+            /* $2F */ { Mnemonic::RLA, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $30 */ { Mnemonic::BMI, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $31 */ { Mnemonic::AND, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $32 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $33 */ { Mnemonic::RLA, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $34 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $35 */ { Mnemonic::AND, AddrMode::ZeroPageX,   4, 0 },
+            /* $36 */ { Mnemonic::ROL, AddrMode::ZeroPageX,   6, 0 },
+            /* $37 */ { Mnemonic::RLA, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $38 */ { Mnemonic::SEC, AddrMode::Implied,     2, 0 },
+            /* $39 */ { Mnemonic::AND, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $3A */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $3B */ { Mnemonic::RLA, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $3C */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $3D */ { Mnemonic::AND, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $3E */ { Mnemonic::ROL, AddrMode::AbsoluteX,   7, 0 },
+            /* $3F */ { Mnemonic::RLA, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            /* $40 */ { Mnemonic::RTI, AddrMode::Implied,     6, 0 },
+            /* $41 */ { Mnemonic::EOR, AddrMode::IndirectX,   6, 0 },
+            /* $42 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $43 */ { Mnemonic::SRE, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $44 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $45 */ { Mnemonic::EOR, AddrMode::ZeroPage,    3, 0 },
+            /* $46 */ { Mnemonic::LSR, AddrMode::ZeroPage,    5, 0 },
+            /* $47 */ { Mnemonic::SRE, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $48 */ { Mnemonic::PHA, AddrMode::Implied,     3, 0 },
+            /* $49 */ { Mnemonic::EOR, AddrMode::Immediate,   2, 0 },
+            /* $4A */ { Mnemonic::LSR, AddrMode::Accumulator, 2, 0 },
+            /* $4B */ { Mnemonic::ALR, AddrMode::Immediate,   2, Encoding::Undocumented },
+            /* $4C */ { Mnemonic::JMP, AddrMode::Absolute,    3, 0 },
+            /* $4D */ { Mnemonic::EOR, AddrMode::Absolute,    4, 0 },
+            /* $4E */ { Mnemonic::LSR, AddrMode::Absolute,    6, 0 },
+            /* $4F */ { Mnemonic::SRE, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $50 */ { Mnemonic::BVC, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $51 */ { Mnemonic::EOR, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $52 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $53 */ { Mnemonic::SRE, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $54 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $55 */ { Mnemonic::EOR, AddrMode::ZeroPageX,   4, 0 },
+            /* $56 */ { Mnemonic::LSR, AddrMode::ZeroPageX,   6, 0 },
+            /* $57 */ { Mnemonic::SRE, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $58 */ { Mnemonic::CLI, AddrMode::Implied,     2, 0 },
+            /* $59 */ { Mnemonic::EOR, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $5A */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $5B */ { Mnemonic::SRE, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $5C */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $5D */ { Mnemonic::EOR, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $5E */ { Mnemonic::LSR, AddrMode::AbsoluteX,   7, 0 },
+            /* $5F */ { Mnemonic::SRE, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            /* $60 */ { Mnemonic::RTS, AddrMode::Implied,     6, 0 },
+            /* $61 */ { Mnemonic::ADC, AddrMode::IndirectX,   6, 0 },
+            /* $62 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $63 */ { Mnemonic::RRA, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $64 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $65 */ { Mnemonic::ADC, AddrMode::ZeroPage,    3, 0 },
+            /* $66 */ { Mnemonic::ROR, AddrMode::ZeroPage,    5, 0 },
+            /* $67 */ { Mnemonic::RRA, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $68 */ { Mnemonic::PLA, AddrMode::Implied,     4, 0 },
+            /* $69 */ { Mnemonic::ADC, AddrMode::Immediate,   2, 0 },
+            /* $6A */ { Mnemonic::ROR, AddrMode::Accumulator, 2, 0 },
+            /* $6B */ { Mnemonic::ARR, AddrMode::Immediate,   2, Encoding::Undocumented },
+            /* $6C */ { Mnemonic::JMP, AddrMode::Indirect,    5, 0 },
+            /* $6D */ { Mnemonic::ADC, AddrMode::Absolute,    4, 0 },
+            /* $6E */ { Mnemonic::ROR, AddrMode::Absolute,    6, 0 },
+            /* $6F */ { Mnemonic::RRA, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $70 */ { Mnemonic::BVS, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $71 */ { Mnemonic::ADC, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $72 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $73 */ { Mnemonic::RRA, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $74 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $75 */ { Mnemonic::ADC, AddrMode::ZeroPageX,   4, 0 },
+            /* $76 */ { Mnemonic::ROR, AddrMode::ZeroPageX,   6, 0 },
+            /* $77 */ { Mnemonic::RRA, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $78 */ { Mnemonic::SEI, AddrMode::Implied,     2, 0 },
+            /* $79 */ { Mnemonic::ADC, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $7A */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $7B */ { Mnemonic::RRA, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $7C */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $7D */ { Mnemonic::ADC, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $7E */ { Mnemonic::ROR, AddrMode::AbsoluteX,   7, 0 },
+            /* $7F */ { Mnemonic::RRA, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            /* $80 */ { Mnemonic::NOP, AddrMode::Immediate,   2, Encoding::Undocumented },
+            /* $81 */ { Mnemonic::STA, AddrMode::IndirectX,   6, 0 },
+            /* $82 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $83 */ { Mnemonic::SAX, AddrMode::IndirectX,   6, Encoding::Undocumented },
+            /* $84 */ { Mnemonic::STY, AddrMode::ZeroPage,    3, 0 },
+            /* $85 */ { Mnemonic::STA, AddrMode::ZeroPage,    3, 0 },
+            /* $86 */ { Mnemonic::STX, AddrMode::ZeroPage,    3, 0 },
+            /* $87 */ { Mnemonic::SAX, AddrMode::ZeroPage,    3, Encoding::Undocumented },
+            /* $88 */ { Mnemonic::DEY, AddrMode::Implied,     2, 0 },
+            /* $89 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $8A */ { Mnemonic::TXA, AddrMode::Implied,     2, 0 },
+            /* $8B */ { Mnemonic::XAA, AddrMode::Immediate,   2, Encoding::Undocumented | Encoding::Unstable },
+            /* $8C */ { Mnemonic::STY, AddrMode::Absolute,    4, 0 },
+            /* $8D */ { Mnemonic::STA, AddrMode::Absolute,    4, 0 },
+            /* $8E */ { Mnemonic::STX, AddrMode::Absolute,    4, 0 },
+            /* $8F */ { Mnemonic::SAX, AddrMode::Absolute,    4, Encoding::Undocumented },
+            /* $90 */ { Mnemonic::BCC, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $91 */ { Mnemonic::STA, AddrMode::IndirectY,   6, 0 },
+            /* $92 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $93 */ { Mnemonic::AHX, AddrMode::IndirectY,   6, Encoding::Undocumented | Encoding::Unstable },
+            /* $94 */ { Mnemonic::STY, AddrMode::ZeroPageX,   4, 0 },
+            /* $95 */ { Mnemonic::STA, AddrMode::ZeroPageX,   4, 0 },
+            /* $96 */ { Mnemonic::STX, AddrMode::ZeroPageY,   4, 0 },
+            /* $97 */ { Mnemonic::SAX, AddrMode::ZeroPageY,   4, Encoding::Undocumented },
+            /* $98 */ { Mnemonic::TYA, AddrMode::Implied,     2, 0 },
+            /* $99 */ { Mnemonic::STA, AddrMode::AbsoluteY,   5, 0 },
+            /* $9A */ { Mnemonic::TXS, AddrMode::Implied,     2, 0 },
+            /* $9B */ { Mnemonic::TAS, AddrMode::AbsoluteY,   5, Encoding::Undocumented | Encoding::Unstable },
+            /* $9C */ { Mnemonic::SHY, AddrMode::AbsoluteX,   5, Encoding::Undocumented | Encoding::Unstable },
+            /* $9D */ { Mnemonic::STA, AddrMode::AbsoluteX,   5, 0 },
+            /* $9E */ { Mnemonic::SHX, AddrMode::AbsoluteY,   5, Encoding::Undocumented | Encoding::Unstable },
+            /* $9F */ { Mnemonic::AHX, AddrMode::AbsoluteY,   5, Encoding::Undocumented | Encoding::Unstable },
+            /* $A0 */ { Mnemonic::LDY, AddrMode::Immediate,   2, 0 },
+            /* $A1 */ { Mnemonic::LDA, AddrMode::IndirectX,   6, 0 },
+            /* $A2 */ { Mnemonic::LDX, AddrMode::Immediate,   2, 0 },
+            /* $A3 */ { Mnemonic::LAX, AddrMode::IndirectX,   6, Encoding::Undocumented },
+            /* $A4 */ { Mnemonic::LDY, AddrMode::ZeroPage,    3, 0 },
+            /* $A5 */ { Mnemonic::LDA, AddrMode::ZeroPage,    3, 0 },
+            /* $A6 */ { Mnemonic::LDX, AddrMode::ZeroPage,    3, 0 },
+            /* $A7 */ { Mnemonic::LAX, AddrMode::ZeroPage,    3, Encoding::Undocumented },
+            /* $A8 */ { Mnemonic::TAY, AddrMode::Implied,     2, 0 },
+            /* $A9 */ { Mnemonic::LDA, AddrMode::Immediate,   2, 0 },
+            /* $AA */ { Mnemonic::TAX, AddrMode::Implied,     2, 0 },
+            /* $AB */ { Mnemonic::LAX, AddrMode::Immediate,   2, Encoding::Undocumented | Encoding::Unstable },
+            /* $AC */ { Mnemonic::LDY, AddrMode::Absolute,    4, 0 },
+            /* $AD */ { Mnemonic::LDA, AddrMode::Absolute,    4, 0 },
+            /* $AE */ { Mnemonic::LDX, AddrMode::Absolute,    4, 0 },
+            /* $AF */ { Mnemonic::LAX, AddrMode::Absolute,    4, Encoding::Undocumented },
+            /* $B0 */ { Mnemonic::BCS, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $B1 */ { Mnemonic::LDA, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $B2 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $B3 */ { Mnemonic::LAX, AddrMode::IndirectY,   5, Encoding::ExtraClocks | Encoding::Undocumented },
+            /* $B4 */ { Mnemonic::LDY, AddrMode::ZeroPageX,   4, 0 },
+            /* $B5 */ { Mnemonic::LDA, AddrMode::ZeroPageX,   4, 0 },
+            /* $B6 */ { Mnemonic::LDX, AddrMode::ZeroPageY,   4, 0 },
+            /* $B7 */ { Mnemonic::LAX, AddrMode::ZeroPageY,   4, Encoding::Undocumented },
+            /* $B8 */ { Mnemonic::CLV, AddrMode::Implied,     2, 0 },
+            /* $B9 */ { Mnemonic::LDA, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $BA */ { Mnemonic::TSX, AddrMode::Implied,     2, 0 },
+            /* $BB */ { Mnemonic::LAS, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks | Encoding::Undocumented },
+            /* $BC */ { Mnemonic::LDY, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $BD */ { Mnemonic::LDA, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $BE */ { Mnemonic::LDX, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $BF */ { Mnemonic::LAX, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks | Encoding::Undocumented },
+            /* $C0 */ { Mnemonic::CPY, AddrMode::Immediate,   2, 0 },
+            /* $C1 */ { Mnemonic::CMP, AddrMode::IndirectX,   6, 0 },
+            /* $C2 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $C3 */ { Mnemonic::DCP, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $C4 */ { Mnemonic::CPY, AddrMode::ZeroPage,    3, 0 },
+            /* $C5 */ { Mnemonic::CMP, AddrMode::ZeroPage,    3, 0 },
+            /* $C6 */ { Mnemonic::DEC, AddrMode::ZeroPage,    5, 0 },
+            /* $C7 */ { Mnemonic::DCP, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $C8 */ { Mnemonic::INY, AddrMode::Implied,     2, 0 },
+            /* $C9 */ { Mnemonic::CMP, AddrMode::Immediate,   2, 0 },
+            /* $CA */ { Mnemonic::DEX, AddrMode::Implied,     2, 0 },
+            /* $CB */ { Mnemonic::AXS, AddrMode::Immediate,   2, Encoding::Undocumented },
+            /* $CC */ { Mnemonic::CPY, AddrMode::Absolute,    4, 0 },
+            /* $CD */ { Mnemonic::CMP, AddrMode::Absolute,    4, 0 },
+            /* $CE */ { Mnemonic::DEC, AddrMode::Absolute,    6, 0 },
+            /* $CF */ { Mnemonic::DCP, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $D0 */ { Mnemonic::BNE, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $D1 */ { Mnemonic::CMP, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $D2 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $D3 */ { Mnemonic::DCP, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $D4 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $D5 */ { Mnemonic::CMP, AddrMode::ZeroPageX,   4, 0 },
+            /* $D6 */ { Mnemonic::DEC, AddrMode::ZeroPageX,   6, 0 },
+            /* $D7 */ { Mnemonic::DCP, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $D8 */ { Mnemonic::CLD, AddrMode::Implied,     2, 0 },
+            /* $D9 */ { Mnemonic::CMP, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $DA */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $DB */ { Mnemonic::DCP, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $DC */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $DD */ { Mnemonic::CMP, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $DE */ { Mnemonic::DEC, AddrMode::AbsoluteX,   7, 0 },
+            /* $DF */ { Mnemonic::DCP, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            /* $E0 */ { Mnemonic::CPX, AddrMode::Immediate,   2, 0 },
+            /* $E1 */ { Mnemonic::SBC, AddrMode::IndirectX,   6, 0 },
+            /* $E2 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $E3 */ { Mnemonic::ISC, AddrMode::IndirectX,   8, Encoding::Undocumented },
+            /* $E4 */ { Mnemonic::CPX, AddrMode::ZeroPage,    3, 0 },
+            /* $E5 */ { Mnemonic::SBC, AddrMode::ZeroPage,    3, 0 },
+            /* $E6 */ { Mnemonic::INC, AddrMode::ZeroPage,    5, 0 },
+            /* $E7 */ { Mnemonic::ISC, AddrMode::ZeroPage,    5, Encoding::Undocumented },
+            /* $E8 */ { Mnemonic::INX, AddrMode::Implied,     2, 0 },
+            /* $E9 */ { Mnemonic::SBC, AddrMode::Immediate,   2, 0 },
+            /* $EA */ { Mnemonic::NOP, AddrMode::Implied,     2, 0 },
+            /* $EB */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $EC */ { Mnemonic::CPX, AddrMode::Absolute,    4, 0 },
+            /* $ED */ { Mnemonic::SBC, AddrMode::Absolute,    4, 0 },
+            /* $EE */ { Mnemonic::INC, AddrMode::Absolute,    6, 0 },
+            /* $EF */ { Mnemonic::ISC, AddrMode::Absolute,    6, Encoding::Undocumented },
+            /* $F0 */ { Mnemonic::BEQ, AddrMode::Relative,    2, Encoding::ExtraClocks },
+            /* $F1 */ { Mnemonic::SBC, AddrMode::IndirectY,   5, Encoding::ExtraClocks },
+            /* $F2 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $F3 */ { Mnemonic::ISC, AddrMode::IndirectY,   8, Encoding::Undocumented },
+            /* $F4 */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $F5 */ { Mnemonic::SBC, AddrMode::ZeroPageX,   4, 0 },
+            /* $F6 */ { Mnemonic::INC, AddrMode::ZeroPageX,   6, 0 },
+            /* $F7 */ { Mnemonic::ISC, AddrMode::ZeroPageX,   6, Encoding::Undocumented },
+            /* $F8 */ { Mnemonic::SED, AddrMode::Implied,     2, 0 },
+            /* $F9 */ { Mnemonic::SBC, AddrMode::AbsoluteY,   4, Encoding::ExtraClocks },
+            /* $FA */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $FB */ { Mnemonic::ISC, AddrMode::AbsoluteY,   7, Encoding::Undocumented },
+            /* $FC */ { Mnemonic::None, AddrMode::Implied,     0, 0 },
+            /* $FD */ { Mnemonic::SBC, AddrMode::AbsoluteX,   4, Encoding::ExtraClocks },
+            /* $FE */ { Mnemonic::INC, AddrMode::AbsoluteX,   7, 0 },
+            /* $FF */ { Mnemonic::ISC, AddrMode::AbsoluteX,   7, Encoding::Undocumented },
+            };
+
+            constexpr const char *MNEMONIC_NAMES[MNEMONICS] = {
+            "ADC", "AHX", "ALR", "ANC", "AND", "ARR", "ASL", "AXS",
+            "BCC", "BCS", "BEQ", "BIT", "BMI", "BNE", "BPL", "BRK",
+            "BVC", "BVS", "CLC", "CLD", "CLI", "CLV", "CMP", "CPX",
+            "CPY", "DCP", "DEC", "DEX", "DEY", "EOR", "INC", "INX",
+            "INY", "ISC", "JMP", "JSR", "LAS", "LAX", "LDA", "LDX",
+            "LDY", "LSR", "NOP", "ORA", "PHA", "PHP", "PLA", "PLP",
+            "RLA", "ROL", "ROR", "RRA", "RTI", "RTS", "SAX", "SBC",
+            "SEC", "SED", "SEI", "SHX", "SHY", "SLO", "SRE", "STA",
+            "STX", "STY", "TAS", "TAX", "TAY", "TSX", "TXA", "TXS",
+            "TYA", "XAA",
+            };
+
+            struct InstructionTable 
+            {
+                Instruction instructions[MNEMONICS];
+            };
+
+            /**
+             * Invert the opcode table into a table of instructions indexed by
+             * mnemonic, each holding its encodings indexed by addressing mode.
+             */
+            constexpr InstructionTable makeInstructionTable()
+            {
+                InstructionTable table{};
+
+                for (int i = 0; i < MNEMONICS; i++) {
+                    table.instructions[i] = Instruction{ static_cast<Mnemonic>(i) };
+                }
 
-        /** 
-         * Construct an instruction encoding
-         */ 
-        Encoding::Encoding(unsigned opcode)
-            : exists_(true)
-            , opcode_(opcode)
-            , clocks_(0)
-            , undocumented_(false)
-            , unstable_(false)
-            , extraClocks_(false)
-        {
-        }
+                for (unsigned op = 0; op < 256; op++) {
+                    const OpcodeInfo &info = OPCODES[op];
+                    if (info.mnemonic != Mnemonic::None) {
+                        table.instructions[static_cast<int>(info.mnemonic)]
+                            .addEncoding(info.mode, Encoding{ op, info.clocks, info.flags });
+                    }
+                }
 
+                return table;
+            }
 
-        /**
-         * Mark an encoding as undocumented
-         */
-        Encoding &Encoding::setUndocumented()
-        {
-            undocumented_ = true;
-            return *this;
-        }
+            constexpr InstructionTable INSTRUCTIONS = makeInstructionTable();
+
+            /**
+             * Pass 1 only decides between zero page and absolute encodings,
+             * so any instruction with a zero page mode must also have the
+             * matching absolute mode.
+             */
+            constexpr bool zeroPageHasAbsolute()
+            {
+                for (const Instruction &instr : INSTRUCTIONS.instructions) {
+                    if (instr.hasEncoding(AddrMode::ZeroPage) && !instr.hasEncoding(AddrMode::Absolute)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
 
-        /**
-         * Mark an encoding as unstablke
-         */
-        Encoding &Encoding::setUnstable()
-        {
-            unstable_ = true;
-            return *this;
-        }
+            static_assert(zeroPageHasAbsolute(), "zero page encoding without matching absolute encoding");
 
-        /**
-         * Set the base number of clocks (the instruction may take more due
-         * to branching or page crossings, if so, extra clocks will be set) 
-         */
-        Encoding &Encoding::setClocks(int clocks)
-        {
-            clocks_ = clocks;
-            return *this;
-        }
+            // Mnemonic recognition for the scanner uses a minimal perfect hash
+            // which is generated at compile time from MNEMONIC_NAMES. Every
+            // mnemonic is three letters, so the key is the three letters folded
+            // to five bits each; folding also makes the hash case insensitive.
+            // Keys are first hashed into buckets, and each bucket gets a seed,
+            // found by search, which sends its keys to distinct free slots.
+            //
+            constexpr int MNEMONIC_LENGTH = 3;
+            constexpr unsigned HASH_BUCKETS = 32;
+            constexpr unsigned MAX_HASH_SEED = 0xFFFF;
+
+            struct MnemonicHash
+            {
+                bool complete;
+                uint16_t seeds[HASH_BUCKETS];
+                Mnemonic slots[MNEMONICS];
+            };
+
+            constexpr unsigned hashKey(const char *text)
+            {
+                return ((text[0] & 0x1F) << 10) | ((text[1] & 0x1F) << 5) | (text[2] & 0x1F);
+            }
 
-        /**
-         * Mark an encoding as undocumented
-         */
-        Encoding &Encoding::setExtraClocks()
-        {
-            extraClocks_ = true;
-            return *this;
-        }
+            constexpr uint32_t hash(unsigned key, unsigned seed)
+            {
+                uint32_t x = key * 0x9E3779B1u + seed * 0x85EBCA6Bu;
+                x ^= x >> 15;
+                x *= 0x2C1B3C6Du;
+                x ^= x >> 12;
+                return x;
+            }
 
-        /**
-         * True if this encoding exists. False if this is a marker
-         * for a non-existent encoding in the opcode map.
-         */
-        bool Encoding::exists() const
-        {
-            return exists_;
-        }
+            constexpr unsigned hashBucket(unsigned key)
+            {
+                return hash(key, 0) % HASH_BUCKETS;
+            }
 
-        /**
-         * Return the one-byte opcode for this encoding
-         */
-        unsigned Encoding::opcode() const
-        {
-            return opcode_;
-        }
-        
-        /**
-         * Returns true if the instruction or this encoding is undocumented
-         */
-        bool Encoding::undocumented() const
-        {
-            return undocumented_;
-        }
+            constexpr unsigned hashSlot(unsigned key, unsigned seed)
+            {
+                return hash(key, seed) % MNEMONICS;
+            }
 
-        /**
-         * Returns true if the instruction or this encoding have been
-         * reported to be unstable on some processors.
-         */
-        bool Encoding::unstable() const
-        {
-            return unstable_;
-        }
+            /**
+             * Find a seed for the keys in `bucket', given the slots already
+             * taken by other buckets, and claim the slots it maps to. Returns
+             * false if there is no such seed.
+             */
+            constexpr bool placeBucket(MnemonicHash &table, unsigned bucket, bool (&used)[MNEMONICS])
+            {
+                for (unsigned seed = 1; seed <= MAX_HASH_SEED; seed++) {
+                    bool taken[MNEMONICS] = {};
+                    bool fits = true;
+
+                    for (int i = 0; i < MNEMONICS && fits; i++) {
+                        unsigned key = hashKey(MNEMONIC_NAMES[i]);
+                        if (hashBucket(key) != bucket) {
+                            continue;
+                        }
+
+                        unsigned slot = hashSlot(key, seed);
+                        if (used[slot] || taken[slot]) {
+                            fits = false;
+                        }
+                        taken[slot] = true;
+                    }
+
+                    if (fits) {
+                        for (int i = 0; i < MNEMONICS; i++) {
+                            unsigned key = hashKey(MNEMONIC_NAMES[i]);
+                            if (hashBucket(key) == bucket) {
+                                unsigned slot = hashSlot(key, seed);
+                                used[slot] = true;
+                                table.slots[slot] = static_cast<Mnemonic>(i);
+                            }
+                        }
+                        table.seeds[bucket] = static_cast<uint16_t>(seed);
+                        return true;
+                    }
+                }
 
-        /**
-         * Returns the base number of clocks for the encoding
-         */
-        int Encoding::clocks() const
-        {
-            return clocks_;
-        }
+                return false;
+            }
 
-        /**
-         * Returns true if there are conditions where the instruction can
-         * take more than the base number of clock cycles.
-         */
-        bool Encoding::extraClocks() const
-        {
-            return extraClocks_;
-        }
+            /**
+             * Build the hash, placing the largest buckets first while there
+             * are the most free slots.
+             */
+            constexpr MnemonicHash makeMnemonicHash()
+            {
+                MnemonicHash table{};
+                bool used[MNEMONICS] = {};
+                unsigned sizes[HASH_BUCKETS] = {};
+                unsigned largest = 0;
+
+                for (int i = 0; i < MNEMONICS; i++) {
+                    unsigned bucket = hashBucket(hashKey(MNEMONIC_NAMES[i]));
+                    sizes[bucket]++;
+                    largest = std::max(largest, sizes[bucket]);
+                }
 
-        /**
-         * Default constructor
-         */
-        Instruction::Instruction()
-        {
-        }
+                table.complete = true;
+                for (unsigned size = largest; size > 0; size--) {
+                    for (unsigned bucket = 0; bucket < HASH_BUCKETS; bucket++) {
+                        if (sizes[bucket] == size && !placeBucket(table, bucket, used)) {
+                            table.complete = false;
+                        }
+                    }
+                }
 
-        /**
-         * Constructor
-         */
-        Instruction::Instruction(const string& mnemonic)
-            : mnemonic_(mnemonic)
-        {
-        }
+                return table;
+            }
 
-        /**
-         * Add the encoding for an addressing mode to an instruction.
-         */
-        Instruction &Instruction::addEncoding(AddrMode mode, const Encoding &encoding)
-        {
-            encodings_[mode] = encoding;
-            return *this;
+            constexpr MnemonicHash MNEMONIC_HASH = makeMnemonicHash();
+
+            static_assert(MNEMONIC_HASH.complete, "could not build the mnemonic hash");
         }
 
         /**
@@ -173,1328 +490,51 @@ namespace yas6502
          */ 
         string Instruction::mnemonic() const
         {
-            return mnemonic_;
+            return mnemonicName(mnemonic_);
         }
 
-        /** 
-         * Test if the instruction has an encoding
+        /**
+         * Return the name of a mnemonic
          */
-        bool Instruction::hasEncoding(AddrMode mode) const
+        const char *mnemonicName(Mnemonic mnemonic)
         {
-            return encodings_.find(mode) != encodings_.end();
+            return MNEMONIC_NAMES[static_cast<int>(mnemonic)];
         }
 
         /**
-         * Return a mode encoding for the instruction
+         * Return the instruction for a mnemonic
          */
-        const Encoding &Instruction::encoding(AddrMode mode) const 
+        const Instruction &instruction(Mnemonic mnemonic)
         {
-            auto it = encodings_.find(mode);
-            if (it != encodings_.end()) {
-                return it->second;
-            }
-
-            return nullEncoding_;
+            return INSTRUCTIONS.instructions[static_cast<int>(mnemonic)];
         }
-        
-        OpcodeMap makeOpcodeMap()
-        {
-            OpcodeMap opcodes{};
-
-            Instruction ADC("ADC");
-            ADC
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x69 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x65 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x75 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x6D }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x7D }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x79 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x61 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x71 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["ADC"] = ADC;
 
-            Instruction AND("AND");
-            AND
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x29 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x25 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x35 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x2D }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x3D }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x39 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x21 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x31 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["AND"] = AND;
-
-            Instruction ASL("ASL");
-            ASL
-            .addEncoding(AddrMode::Accumulator,
-                Encoding{ 0x0A }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x06 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x16 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x0E }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x1E }
-                    .setClocks(7)
-            );
-            opcodes["ASL"] = ASL;
-
-            Instruction BCC("BCC");
-            BCC
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0x90 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BCC"] = BCC;
-
-            Instruction BCS("BCS");
-            BCS
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0xB0 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BCS"] = BCS;
-
-            Instruction BEQ("BEQ");
-            BEQ
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0xF0 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BEQ"] = BEQ;
-
-            Instruction BIT("BIT");
-            BIT
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x24 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x2C }
-                    .setClocks(4)
-            );
-            opcodes["BIT"] = BIT;
-
-            Instruction BMI("BMI");
-            BMI
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0x30 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BMI"] = BMI;
-
-            Instruction BNE("BNE");
-            BNE
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0xD0 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BNE"] = BNE;
-
-            Instruction BPL("BPL");
-            BPL
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0x10 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BPL"] = BPL;
-
-            Instruction BRK("BRK");
-            BRK
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x00 }
-                    .setClocks(7)
-            );
-            opcodes["BRK"] = BRK;
-
-            Instruction BVC("BVC");
-            BVC
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0x50 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BVC"] = BVC;
-
-            Instruction BVS("BVS");
-            BVS
-            .addEncoding(AddrMode::Relative,
-                Encoding{ 0x70 }
-                    .setClocks(2)
-                    .setExtraClocks()
-            );
-            opcodes["BVS"] = BVS;
-
-            Instruction CLC("CLC");
-            CLC
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x18 }
-                    .setClocks(2)
-            );
-            opcodes["CLC"] = CLC;
-
-            Instruction CLD("CLD");
-            CLD
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xD8 }
-                    .setClocks(2)
-            );
-            opcodes["CLD"] = CLD;
-
-            Instruction CLI("CLI");
-            CLI
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x58 }
-                    .setClocks(2)
-            );
-            opcodes["CLI"] = CLI;
-
-            Instruction CLV("CLV");
-            CLV
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xB8 }
-                    .setClocks(2)
-            );
-            opcodes["CLV"] = CLV;
-
-            Instruction CMP("CMP");
-            CMP
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xC9 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xC5 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xD5 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xCD }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xDD }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xD9 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-              Encoding{ 0xC1 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xD1 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["CMP"] = CMP;
-
-            Instruction CPX("CPX");
-            CPX
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xE0 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xE4 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xEC }
-                    .setClocks(4)
-            );
-            opcodes["CPX"] = CPX;
-
-            Instruction CPY("CPY");
-            CPY
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xC0 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xC4 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xCC }
-                    .setClocks(4)
-            );
-            opcodes["CPY"] = CPY;
-
-            Instruction DEC("DEC");
-            DEC
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xC6 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xD6 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xCE }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xDE }
-                    .setClocks(7)
-            );
-            opcodes["DEC"] = DEC;
-
-            Instruction DEX("DEX");
-            DEX
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xCA }
-                    .setClocks(2)
-            );
-            opcodes["DEX"] = DEX;
-
-            Instruction DEY("DEY");
-            DEY
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x88 }
-                    .setClocks(2)
-            );
-            opcodes["DEY"] = DEY;
-
-            Instruction EOR("EOR");
-            EOR
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x49 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x45 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x55 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x4D }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x5D }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x59 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x41 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x51 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["EOR"] = EOR;
-
-            Instruction INC("INC");
-            INC
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xE6 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xF6 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xEE }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xFE }
-                    .setClocks(7)
-            );
-            opcodes["INC"] = INC;
-
-            Instruction INX("INX");
-            INX
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xE8 }
-                    .setClocks(2)
-            );
-            opcodes["INX"] = INX;
-
-            Instruction INY("INY");
-            INY
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xC8 }
-                    .setClocks(2)
-            );
-            opcodes["INY"] = INY;
-
-            Instruction JMP("JMP");
-            JMP
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x4C }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::Indirect,
-                Encoding{ 0x6C }
-                    .setClocks(5)
-            );
-            opcodes["JMP"] = JMP;
-
-            Instruction JSR("JSR");
-            JSR
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x20 }
-                    .setClocks(6)
-            );
-            opcodes["JSR"] = JSR;
-
-            Instruction LDA("LDA");
-            LDA
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xA9 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xA5 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xB5 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xAD }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xBD }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xB9 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0xA1 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xB1 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["LDA"] = LDA;
-
-            Instruction LDX("LDX");
-            LDX
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xA2 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xA6 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageY,
-                Encoding{ 0xB6 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xAE }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xBE }
-                    .setClocks(4)
-                    .setExtraClocks()
-            );
-            opcodes["LDX"] = LDX;
-
-            Instruction LDY("LDY");
-            LDY
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xA0 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xA4 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xB4 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xAC }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xBC }
-                    .setClocks(4)
-                    .setExtraClocks()
-            );
-            opcodes["LDY"] = LDY;
-
-            Instruction LSR("LSR");
-            LSR
-            .addEncoding(AddrMode::Accumulator,
-                Encoding{ 0x4A }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x46 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x56 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x4E }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x5E }
-                    .setClocks(7)
-            );
-            opcodes["LSR"] = LSR;
-
-            Instruction NOP("NOP");
-            NOP
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xEA }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x80 }
-                    .setClocks(2)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x04 }
-                    .setClocks(3)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x14 }
-                    .setClocks(4)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x0C }
-                    .setClocks(4)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x1C }
-                    .setClocks(4)
-                    .setExtraClocks()
-                    .setUndocumented()
-            );
-            opcodes["NOP"] = NOP;
-
-            Instruction ORA("ORA");
-            ORA
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x09 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x05 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x15 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x0D }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x1D }
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x19 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x01 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x11 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["ORA"] = ORA;
-
-            Instruction PHA("PHA");
-            PHA
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x48 }
-                    .setClocks(3)
-            );
-            opcodes["PHA"] = PHA;
-
-            Instruction PHP("PHP");
-            PHP
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x08 }
-                    .setClocks(3)
-            );
-            opcodes["PHP"] = PHP;
-
-            Instruction PLA("PLA");
-            PLA
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x68 }
-                    .setClocks(4)
-            );
-            opcodes["PLA"] = PLA;
-
-            Instruction PLP("PLP");
-            PLP
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x28 }
-                    .setClocks(4)
-            );
-            opcodes["PLP"] = PLP;
-
-            Instruction ROL("ROL");
-            ROL
-            .addEncoding(AddrMode::Accumulator,
-                Encoding{ 0x2A }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x26 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x36 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x2E }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x3E }
-                    .setClocks(7)
-            );
-            opcodes["ROL"] = ROL;
-
-            Instruction ROR("ROR");
-            ROR
-            .addEncoding(AddrMode::Accumulator,
-                Encoding{ 0x6A }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x66 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x76 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x6E }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x7E }
-                    .setClocks(7)
-            );
-            opcodes["ROR"] = ROR;
-
-            Instruction RTI("RTI");
-            RTI
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x40 }
-                    .setClocks(6)
-            );
-            opcodes["RTI"] = RTI;
-
-            Instruction RTS("RTS");
-            RTS
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x60 }
-                    .setClocks(6)
-            );
-            opcodes["RTS"] = RTS;
-
-            Instruction SBC("SBC");
-            SBC
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xE9 }
-                    .setClocks(2)
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xE5 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xF5 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xED }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xFD }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xF9 }
-                    .setClocks(4)
-                    .setExtraClocks()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0xE1 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xF1 }
-                    .setClocks(5)
-                    .setExtraClocks()
-            );
-            opcodes["SBC"] = SBC;
-
-            Instruction SEC("SEC");
-            SEC
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x38 }
-                    .setClocks(2)
-            );
-            opcodes["SEC"] = SEC;
-
-            Instruction SED("SED");
-            SED
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xF8 }
-                    .setClocks(2)
-            );
-            opcodes["SED"] = SED;
-
-            Instruction SEI("SEI");
-            SEI
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x78 }
-                    .setClocks(2)
-            );
-            opcodes["SEI"] = SEI;
-
-            Instruction STA("STA");
-            STA
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x85 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x95 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x8D }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x9D }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x99 }
-                    .setClocks(5)
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x81 }
-                    .setClocks(6)
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x91 }
-                    .setClocks(6)
-            );
-            opcodes["STA"] = STA;
-
-            Instruction STX("STX");
-            STX
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x86 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageY,
-                Encoding{ 0x96 }
-                    .setClocks(4)
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x8E }
-                    .setClocks(4)
-            );
-            opcodes["STX"] = STX;
-
-            Instruction STY("STY");
-            STY
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x84 }
-                    .setClocks(3)
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x94 }
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x8C }
-                    .setClocks(4)
-            );
-            opcodes["STY"] = STY;
-
-            Instruction TAX("TAX");
-            TAX
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xAA }
-                    .setClocks(2)
-            );
-            opcodes["TAX"] = TAX;
-
-            Instruction TAY("TAY");
-            TAY
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xA8 }
-                    .setClocks(2)
-            );
-            opcodes["TAY"] = TAY;
-
-            Instruction TSX("TSX");
-            TSX
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0xBA }
-                    .setClocks(2)
-            );
-            opcodes["TSX"] = TSX;
-
-            Instruction TXA("TXA");
-            TXA
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x8A }
-                    .setClocks(2)
-            );
-            opcodes["TXA"] = TXA;
-
-            Instruction TXS("TXS");
-            TXS
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x9A }
-                    .setClocks(2)
-            );
-            opcodes["TXS"] = TXS;
+        /**
+         * Case insensitively look up a mnemonic, which need not be NUL
+         * terminated. Returns Mnemonic::None if `text' is not a mnemonic.
+         */
+        Mnemonic lookupMnemonic(const char *text, size_t length)
+        {
+            if (length != MNEMONIC_LENGTH) {
+                return Mnemonic::None;
+            }
 
-            Instruction TYA("TYA");
-            TYA
-            .addEncoding(AddrMode::Implied,
-                Encoding{ 0x98 }
-                    .setClocks(2)
-            );
-            opcodes["TYA"] = TYA;
+            unsigned key = hashKey(text);
+            unsigned seed = MNEMONIC_HASH.seeds[hashBucket(key)];
+            Mnemonic mnemonic = MNEMONIC_HASH.slots[hashSlot(key, seed)];
 
-            // Undocumented opcodes. 
+            // The hash only says which mnemonic `text' would have to be; the
+            // key folding maps other characters onto letters, so compare. Only
+            // the two cases of a letter are equal to it after setting bit 5.
             //
-            Instruction SLO("SLO");
-            SLO
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x07 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x17 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x03 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x13 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x0F }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x1F }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x1B }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["SLO"] = SLO;
-
-            Instruction RLA("RLA");
-            RLA
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x27 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x37 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x23 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x33 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x2F }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x3F }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x3B }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["RLA"] = RLA;
-
-            Instruction SRE("SRE");
-            SRE
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x47 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x57 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x43 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x53 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x4F }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x5F }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x5B }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["SRE"] = SRE;
-
-            Instruction RRA("RRA");
-            RRA
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x67 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0x77 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x63 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x73 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x6F }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x7F }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x7B }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["RRA"] = RRA;
-
-            Instruction SAX("SAX");
-            SAX
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0x87 }
-                    .setClocks(3)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageY,
-                Encoding{ 0x97 }
-                    .setClocks(4)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0x83 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0x8F }
-                    .setClocks(4)
-                    .setUndocumented()
-            );
-            opcodes["SAX"] = SAX;
-
-            Instruction LAX("LAX");
-            LAX
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xAB }
-                    .setClocks(2)
-                    .setUndocumented()
-                    .setUnstable()
-            )
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xA7 }
-                    .setClocks(3)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageY,
-                Encoding{ 0xB7 }
-                    .setClocks(4)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0xA3 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xB3 }
-                    .setClocks(5)
-                    .setExtraClocks()
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xAF }
-                    .setClocks(4)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xBF }
-                    .setClocks(4)
-                    .setExtraClocks()
-                    .setUndocumented()
-            );
-            opcodes["LAX"] = LAX;
-
-            Instruction DCP("DCP");
-            DCP
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xC7 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xD7 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0xC3 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xD3 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xCF }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xDF }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xDB }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["DCP"] = DCP;
-
-            Instruction ISC("ISC");
-            ISC
-            .addEncoding(AddrMode::ZeroPage,
-                Encoding{ 0xE7 }
-                    .setClocks(5)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::ZeroPageX,
-                Encoding{ 0xF7 }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectX,
-                Encoding{ 0xE3 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0xF3 }
-                    .setClocks(8)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::Absolute,
-                Encoding{ 0xEF }
-                    .setClocks(6)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0xFF }
-                    .setClocks(7)
-                    .setUndocumented()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xFB }
-                    .setClocks(7)
-                    .setUndocumented()
-            );
-            opcodes["ISC"] = ISC;
-
-            Instruction ANC("ANC");
-            ANC
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x0B }
-                    .setClocks(2)
-                    .setUndocumented()
-            );
-            opcodes["ANC"] = ANC;
-
-            Instruction ALR("ALR");
-            ALR
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x4B }
-                    .setClocks(2)
-                    .setUndocumented()
-            );
-            opcodes["ALR"] = ALR;
-
-            Instruction ARR("ARR");
-            ARR
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x6B }
-                    .setClocks(2)
-                    .setUndocumented()
-            );
-            opcodes["ARR"] = ARR;
-
-            Instruction XAA("XAA");
-            XAA
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0x8B }
-                    .setClocks(2)
-                    .setUndocumented()
-                    .setUnstable()
-            );
-            opcodes["XAA"] = XAA;
-
-            Instruction AXS("AXS");
-            AXS
-            .addEncoding(AddrMode::Immediate,
-                Encoding{ 0xCB }
-                    .setClocks(2)
-                    .setUndocumented()
-            );
-            opcodes["AXS"] = AXS;
-
-            Instruction AHX("AHX");
-            AHX 
-            .addEncoding(AddrMode::IndirectY,
-                Encoding{ 0x93 }
-                    .setClocks(6)
-                    .setUndocumented()
-                    .setUnstable()
-            )
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x9F }
-                    .setClocks(5)
-                    .setUndocumented()
-                    .setUnstable()
-            );
-            opcodes["AHX"] = AHX;
-
-            Instruction SHX("SHX");
-            SHX 
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x9E }
-                    .setClocks(5)
-                    .setUndocumented()
-                    .setUnstable()
-            );
-            opcodes["SHX"] = SHX;
-
-            Instruction SHY("SHY");
-            SHY 
-            .addEncoding(AddrMode::AbsoluteX,
-                Encoding{ 0x9C }
-                    .setClocks(5)
-                    .setUndocumented()
-                    .setUnstable()
-            );
-            opcodes["SHY"] = SHY;
-
-            Instruction TAS("TAS");
-            TAS 
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0x9B }
-                    .setClocks(5)
-                    .setUndocumented()
-                    .setUnstable()
-            );
-            opcodes["TAS"] = SHY;
-
-            Instruction LAS("LAS");
-            LAS 
-            .addEncoding(AddrMode::AbsoluteY,
-                Encoding{ 0xBB }
-                    .setClocks(4)
-                    .setExtraClocks()
-                    .setUndocumented()
-            );
-            opcodes["LAS"] = LAS;
-
-            for (const auto &p : opcodes) {
-                const Instruction &instr = p.second;
-                if (instr.hasEncoding(AddrMode::ZeroPage)) {
-                    assert(instr.hasEncoding(AddrMode::Absolute));
+            const char *name = MNEMONIC_NAMES[static_cast<int>(mnemonic)];
+            for (int i = 0; i < MNEMONIC_LENGTH; i++) {
+                if ((text[i] | 0x20) != (name[i] | 0x20)) {
+                    return Mnemonic::None;
                 }
             }
-            return opcodes;
+
+            return mnemonic;
         }
     }
 }
-
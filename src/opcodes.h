@@ -22,39 +22,14 @@
 #ifndef OPCODES_H_
 #define OPCODES_H_
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace yas6502
 {
     namespace opcodes
     {
-        class Encoding
-        {
-        public:
-            Encoding();
-            Encoding(unsigned opcode);
-            Encoding &setUndocumented();
-            Encoding &setUnstable();
-            Encoding &setClocks(int clocks);
-            Encoding &setExtraClocks();
-
-            bool exists() const;
-            unsigned opcode() const;
-            bool undocumented() const;
-            bool unstable() const;
-            int clocks() const;
-            bool extraClocks() const;
-
-        private:
-            bool exists_;
-            unsigned opcode_;
-            unsigned clocks_;
-            bool undocumented_;
-            bool unstable_;
-            bool extraClocks_;
-        };
-
         enum class AddrMode
         {
             Accumulator,
@@ -72,29 +47,109 @@ namespace yas6502
             Relative,
         };
 
+        constexpr int ADDR_MODES = static_cast<int>(AddrMode::Relative) + 1;
+
+        enum class Mnemonic : uint8_t
+        {
+            ADC, AHX, ALR, ANC, AND, ARR, ASL, AXS,
+            BCC, BCS, BEQ, BIT, BMI, BNE, BPL, BRK,
+            BVC, BVS, CLC, CLD, CLI, CLV, CMP, CPX,
+            CPY, DCP, DEC, DEX, DEY, EOR, INC, INX,
+            INY, ISC, JMP, JSR, LAS, LAX, LDA, LDX,
+            LDY, LSR, NOP, ORA, PHA, PHP, PLA, PLP,
+            RLA, ROL, ROR, RRA, RTI, RTS, SAX, SBC,
+            SEC, SED, SEI, SHX, SHY, SLO, SRE, STA,
+            STX, STY, TAS, TAX, TAY, TSX, TXA, TXS,
+            TYA, XAA,
+            None,
+        };
+
+        constexpr int MNEMONICS = static_cast<int>(Mnemonic::None);
+
+        /**
+         * One addressing mode encoding of an instruction, packed into 16 bits:
+         * the opcode in the low byte, the base clock count in the next four
+         * bits, and the flags above that.
+         */
+        class Encoding
+        {
+        public:
+            enum Flags : uint16_t
+            {
+                Exists       = 0x1000,
+                Undocumented = 0x2000,
+                Unstable     = 0x4000,
+                ExtraClocks  = 0x8000,
+            };
+
+            constexpr Encoding()
+                : bits_(0)
+            {
+            }
+
+            constexpr Encoding(unsigned opcode, unsigned clocks, unsigned flags)
+                : bits_(static_cast<uint16_t>((opcode & 0xFF) | ((clocks & 0x0F) << 8) | Exists | flags))
+            {
+            }
+
+            constexpr bool exists() const { return (bits_ & Exists) != 0; }
+            constexpr unsigned opcode() const { return bits_ & 0xFF; }
+            constexpr bool undocumented() const { return (bits_ & Undocumented) != 0; }
+            constexpr bool unstable() const { return (bits_ & Unstable) != 0; }
+            constexpr int clocks() const { return (bits_ >> 8) & 0x0F; }
+            constexpr bool extraClocks() const { return (bits_ & ExtraClocks) != 0; }
+
+        private:
+            uint16_t bits_;
+        };
+
+        /**
+         * An instruction and its encodings, indexed by addressing mode.
+         */
         class Instruction
         {
         public:
-            Instruction();
-            Instruction(const std::string &mnemonic);
-            Instruction &addEncoding(AddrMode mode, const Encoding &encoding);
+            constexpr Instruction()
+                : mnemonic_(Mnemonic::None)
+                , encodings_{}
+            {
+            }
+
+            constexpr Instruction(Mnemonic mnemonic)
+                : mnemonic_(mnemonic)
+                , encodings_{}
+            {
+            }
+
+            constexpr Instruction &addEncoding(AddrMode mode, const Encoding &encoding)
+            {
+                encodings_[static_cast<int>(mode)] = encoding;
+                return *this;
+            }
 
             std::string mnemonic() const;
-            bool hasEncoding(AddrMode mode) const;
-            const Encoding &encoding(AddrMode mode) const;
+            constexpr Mnemonic id() const { return mnemonic_; }
+
+            constexpr bool hasEncoding(AddrMode mode) const 
+            { 
+                return encodings_[static_cast<int>(mode)].exists(); 
+            }
+
+            constexpr const Encoding &encoding(AddrMode mode) const 
+            { 
+                return encodings_[static_cast<int>(mode)]; 
+            }
 
         private:
-            Encoding nullEncoding_;
-            std::string mnemonic_;
-            std::map<AddrMode, Encoding> encodings_;
+            Mnemonic mnemonic_;
+            Encoding encodings_[ADDR_MODES];
         };
 
-        using OpcodeMap = std::map<std::string, Instruction>;
-
-        extern OpcodeMap makeOpcodeMap();
+        extern const char *mnemonicName(Mnemonic mnemonic);
+        extern const Instruction &instruction(Mnemonic mnemonic);
+        extern Mnemonic lookupMnemonic(const char *text, size_t length);
     }
 }
 
 #endif
 
-
@@ -23,8 +23,12 @@
 #define PARSER_H_
 # include "parser.tab.hpp"
 # include "assembler.h"
-# define YY_DECL yy::parser::symbol_type yylex(yas6502::Assembler &asmb)
-YY_DECL;
+# include "scanner.h"
+
+inline yy::parser::symbol_type yylex(yas6502::Assembler &asmb, yas6502::Scanner &scanner)
+{
+    return scanner.next(asmb);
+}
 #endif
 
 
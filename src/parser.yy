@@ -34,12 +34,19 @@
     #include <vector>
     #include "ast.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void *yyscan_t;
+    #endif
+
     namespace yas6502 {
         class Assembler;
+        class Scanner;
     }
 }
 
 %param{ yas6502::Assembler &asmb }
+%param{ yas6502::Scanner &scanner }
 
 %locations
 
@@ -50,20 +57,12 @@
 %code {
 #include "parser.h"
 #include "ast.h"
-using std::cerr;
-using std::endl;
 
-using std::make_unique;
 using std::vector;
 
 namespace ast = yas6502::ast;
 using ast::Expression;
-using ast::SymbolExpression;
-using ast::ConstantExpression;
-using ast::LocationExpression;
 using ast::Operator;
-using ast::BinaryOp;
-using ast::UnaryOp;
 using ast::IndexReg;
 using ast::Address;
 using ast::DataElement;
@@ -115,32 +114,31 @@ using ast::NoopNode;
   DOT       "."
   ;
 
-%token <std::string> OPCODE "opcode" 
-%token <std::string> COMMENT "comment"
-%token <std::string> IDENTIFIER "identifier"
-%token <std::string> STRING "string"
+%token <yas6502::ast::Opcode> OPCODE "opcode" 
+%token <yas6502::Text> COMMENT "comment"
+%token <int> IDENTIFIER "identifier"
+%token <yas6502::Text> STRING "string"
 %token <int> NUMBER "number"
 
-%nterm <yas6502::ast::ExpressionPtr> expression
-%nterm <yas6502::ast::ExpressionPtr> uexpr
+%nterm <yas6502::ast::Expression> expression
+%nterm <yas6502::ast::Expression> uexpr
 %nterm <yas6502::ast::IndexReg> index
 %nterm <yas6502::ast::IndexReg> yindex
-%nterm <yas6502::ast::AddressPtr> addressing-mode
-%nterm <std::vector<std::unique_ptr<yas6502::ast::DataElement>>> data-list;
-%nterm <std::unique_ptr<yas6502::ast::DataElement>> data-element;
+%nterm <yas6502::ast::Address> addressing-mode
+%nterm <std::vector<yas6502::ast::DataElement>> data-list;
+%nterm <yas6502::ast::DataElement> data-element;
 %nterm <yas6502::ast::DataSize> data-decl;
 %nterm <yas6502::ast::DataSize> space-decl;
-%nterm <std::unique_ptr<yas6502::ast::Node>> data-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> space-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> ascii-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> instr-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> org-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> set-stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> stmt;
-%nterm <std::unique_ptr<yas6502::ast::Node>> line;
-%nterm <std::vector<std::unique_ptr<yas6502::ast::Node>>> stmt-list;
-%nterm <std::string> label;
-%nterm <std::string> comment;
+%nterm <yas6502::ast::Node *> data-stmt;
+%nterm <yas6502::ast::Node *> space-stmt;
+%nterm <yas6502::ast::Node *> ascii-stmt;
+%nterm <yas6502::ast::Node *> instr-stmt;
+%nterm <yas6502::ast::Node *> org-stmt;
+%nterm <yas6502::ast::Node *> set-stmt;
+%nterm <yas6502::ast::Node *> stmt;
+%nterm <yas6502::ast::Node *> line;
+%nterm <int> label;
+%nterm <yas6502::Text> comment;
 
 %left "|"
 %left "^"
@@ -154,80 +152,79 @@ using ast::NoopNode;
 
 %start program;
 
-program: stmt-list { asmb.setProgram( std::move( $1 ) );  }
+program: stmt-list
 
 stmt-list:  
-    line            { $$.push_back( std::move( $1 ) ); }
-    | stmt-list line  { 
-        $1.push_back( std::move( $2 ) );
-        $$ = std::move( $1 );
-    }
+    line              { asmb.statement( $1 ); }
+    | stmt-list line  { asmb.statement( $2 ); }
 
 line: label stmt comment NEWLINE { 
-    $$ = std::move( $2 ); 
+    $$ = $2; 
     $$->setLine(@1.begin.line);
     $$->setLabel( $1 );
     $$->setComment( $3 );
 }
 
 stmt: 
-    set-stmt      { $$ = std::move( $1 ); } 
-    | org-stmt    { $$ = std::move( $1 ); }
-    | end-stmt    { $$ = make_unique<NoopNode>(); } 
-    | data-stmt   { $$ = std::move( $1 ); }
-    | space-stmt  { $$ = std::move( $1 ); }
-    | instr-stmt  { $$ = std::move( $1 ); } 
-    | ascii-stmt  { $$ = std::move( $1 ); }
-    | %empty      { $$ = make_unique<NoopNode>(); }
+    set-stmt      { $$ = $1; } 
+    | org-stmt    { $$ = $1; }
+    | end-stmt    { $$ = asmb.arena().make<NoopNode>(); } 
+    | data-stmt   { $$ = $1; }
+    | space-stmt  { $$ = $1; }
+    | instr-stmt  { $$ = $1; } 
+    | ascii-stmt  { $$ = $1; }
+    | %empty      { $$ = asmb.arena().make<NoopNode>(); }
 
 label: 
-     %empty             {}
+     %empty             { $$ = yas6502::NO_SYMBOL; }
      | IDENTIFIER ":"   { $$ = $1; }
 
 comment:
        %empty           {}
        | COMMENT        { $$ = $1; }
 
-set-stmt: SET IDENTIFIER "=" expression { $$ = make_unique<SetNode>( $2, std::move( $4 ) ); }
-org-stmt: ORG expression { $$ = make_unique<OrgNode>( std::move( $2 ) ); }
-instr-stmt: OPCODE addressing-mode { $$ = make_unique<InstructionNode>( $1, std::move( $2 ) ); }
+set-stmt: SET IDENTIFIER "=" expression { $$ = asmb.arena().make<SetNode>( $2, $4 ); }
+org-stmt: ORG expression { $$ = asmb.arena().make<OrgNode>( $2 ); }
+instr-stmt: OPCODE addressing-mode { $$ = asmb.arena().make<InstructionNode>( $1.mnemonic, $1.spelling, $2 ); }
 
 ascii-stmt: 
-    ASCII STRING { $$ = make_unique<StringNode>( $2, false ); }
+    ASCII STRING { $$ = asmb.arena().make<StringNode>( $2, false ); }
 
 ascii-stmt: 
-    ASCIIZ STRING { $$ = make_unique<StringNode>( $2, true ); }
+    ASCIIZ STRING { $$ = asmb.arena().make<StringNode>( $2, true ); }
 
 end-stmt: END 
 
-data-stmt: data-decl data-list { $$ = make_unique<DataNode>( $1, std::move( $2 ) ); }
+data-stmt: data-decl <uint32_t>{ $$ = asmb.code().mark(); } data-list { 
+    $$ = ast::makeDataNode( asmb.arena(), asmb.code(), $2, $1, $3 ); 
+}
 data-decl: 
     BYTE    { $$ = ast::DataSize::Byte; } 
     | WORD  { $$ = ast::DataSize::Word; }
 
 data-element: 
-    expression                          { $$ = make_unique<DataElement>(nullptr, std::move( $1 )); }
-    | REP "(" expression ")" expression { $$ = make_unique<DataElement>(std::move( $3 ), std::move( $5 )); }
+    expression                          { $$ = DataElement{ Expression{}, $1 }; }
+    | REP "(" expression ")" expression { $$ = DataElement{ $3, $5 }; }
 
 data-list: 
-    data-element { $$.push_back( std::move( $1 ) ); }
+    data-element { $$.push_back( $1 ); }
     | data-list "," data-element { 
-        $1.push_back(std::move( $3 ));
+        $1.push_back( $3 );
         $$ = std::move($1);
     }
 
-space-stmt: space-decl expression { $$ = make_unique<SpaceNode>( $1, std::move( $2 ) ); }
+space-stmt: space-decl expression { $$ = asmb.arena().make<SpaceNode>( $1, $2 ); }
 space-decl:
     BYTES   { $$ = ast::DataSize::Byte; }
     | WORDS { $$ = ast::DataSize::Word; }
 
 addressing-mode:
-    %empty                        { $$ = make_unique<Address>( ast::AddrMode::Implied, nullptr ); }
-    | "#" expression              { $$ = make_unique<Address>( ast::AddrMode::Immediate, std::move( $2 ) ); } 
-    | "a"                         { $$ = make_unique<Address>( ast::AddrMode::Accumulator, nullptr ); }
-    | expression index            { $$ = make_unique<Address>( ast::address( $2 ), std::move( $1 ) ); }
-    | "[" expression "]" yindex   { $$ = make_unique<Address>( ast::indirect( $4 ), std::move( $2 ) ); }
-    | "[" expression  ",x" "]"    { $$ = make_unique<Address>( ast::AddrMode::IndirectX, std::move( $2 ) ); }
+    %empty                        { $$ = Address{ ast::AddrMode::Implied, Expression{} }; }
+    | "#" expression              { $$ = Address{ ast::AddrMode::Immediate, $2 }; } 
+    | "a"                         { $$ = Address{ ast::AddrMode::Accumulator, Expression{} }; }
+    | expression index            { $$ = Address{ ast::address( $2 ), $1 }; }
+    | "[" expression "]" yindex   { $$ = Address{ ast::indirect( $4 ), $2 }; }
+    | "[" expression  ",x" "]"    { $$ = Address{ ast::AddrMode::IndirectX, $2 }; }
 
 index:
      %empty { $$ = ast::IndexReg::None; }
@@ -240,30 +237,30 @@ yindex:
 
 
 uexpr:
-    NUMBER                        { $$ = make_unique<ConstantExpression>( $1 ); }
-    | IDENTIFIER                  { $$ = make_unique<SymbolExpression>( $1 ); }
-    | "."                         { $$ = make_unique<LocationExpression>(); }
-    | "-" uexpr                   { $$ = make_unique<UnaryOp>( Operator::Neg, std::move( $2 ) ); }
-    | "~" uexpr                   { $$ = make_unique<UnaryOp>( Operator::BitNeg, std::move( $2 ) ); }
+    NUMBER                        { $$ = asmb.code().constant( $1 ); }
+    | IDENTIFIER                  { $$ = asmb.code().symbol( $1 ); }
+    | "."                         { $$ = asmb.code().location(); }
+    | "-" uexpr                   { $$ = asmb.code().unary( Operator::Neg, $2 ); }
+    | "~" uexpr                   { $$ = asmb.code().unary( Operator::BitNeg, $2 ); }
 
 expression:
-    uexpr                         { $$ = std::move( $1 ); }
-    | expression "+" expression   { $$ = make_unique<BinaryOp>( Operator::Add, std::move( $1 ), std::move( $3 ) ); }
-    | expression "-" expression   { $$ = make_unique<BinaryOp>( Operator::Sub, std::move( $1 ), std::move( $3 ) ); }
-    | expression "*" expression   { $$ = make_unique<BinaryOp>( Operator::Mul, std::move( $1 ), std::move( $3 ) ); }
-    | expression "/" expression   { $$ = make_unique<BinaryOp>( Operator::Div, std::move( $1 ), std::move( $3 ) ); }
-    | expression "%" expression   { $$ = make_unique<BinaryOp>( Operator::Mod, std::move( $1 ), std::move( $3 ) ); }
-    | expression "<<" expression  { $$ = make_unique<BinaryOp>( Operator::LShift, std::move( $1 ), std::move( $3 ) ); }
-    | expression ">>" expression  { $$ = make_unique<BinaryOp>( Operator::RShift, std::move( $1 ), std::move( $3 ) ); }
-    | expression "&" expression   { $$ = make_unique<BinaryOp>( Operator::And, std::move( $1 ), std::move( $3 ) ); }
-    | expression "|" expression   { $$ = make_unique<BinaryOp>( Operator::Or, std::move( $1 ), std::move( $3 ) ); }
-    | expression "^" expression   { $$ = make_unique<BinaryOp>( Operator::Xor, std::move( $1 ), std::move( $3 ) ); }
-    | "(" expression ")"          { $$ = std::move( $2 ); $$->setParenthesized(); }
+    uexpr                         { $$ = $1; }
+    | expression "+" expression   { $$ = asmb.code().binary( Operator::Add, $1, $3 ); }
+    | expression "-" expression   { $$ = asmb.code().binary( Operator::Sub, $1, $3 ); }
+    | expression "*" expression   { $$ = asmb.code().binary( Operator::Mul, $1, $3 ); }
+    | expression "/" expression   { $$ = asmb.code().binary( Operator::Div, $1, $3 ); }
+    | expression "%" expression   { $$ = asmb.code().binary( Operator::Mod, $1, $3 ); }
+    | expression "<<" expression  { $$ = asmb.code().binary( Operator::LShift, $1, $3 ); }
+    | expression ">>" expression  { $$ = asmb.code().binary( Operator::RShift, $1, $3 ); }
+    | expression "&" expression   { $$ = asmb.code().binary( Operator::And, $1, $3 ); }
+    | expression "|" expression   { $$ = asmb.code().binary( Operator::Or, $1, $3 ); }
+    | expression "^" expression   { $$ = asmb.code().binary( Operator::Xor, $1, $3 ); }
+    | "(" expression ")"          { $$ = asmb.code().parenthesized( $2 ); }
 
 %%
 
 void yy::parser::error(const location_type& l, const std::string& m)
 {
-  cerr << std::setw(5) << l.begin.line << ": Error: " << m << endl;
+  asmb.syntaxError(l, m);
 }
 
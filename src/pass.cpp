@@ -83,10 +83,10 @@ namespace yas6502
     /**
      * Constructor
      */
-    Pass::Pass(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes)
+    Pass::Pass(SymbolTable &symtab)
         : symtab_(symtab)
-        , opcodes_(opcodes)
         , loc_(0)
+        , line_(0)
         , errors_(0)
         , warnings_(0)
     {
@@ -124,6 +124,34 @@ namespace yas6502
         loc_ = loc;
     }
 
+    /**
+     * Set the source line that warnings and errors are reported
+     * against.
+     */
+    void Pass::setLine(int line)
+    {
+        line_ = line;
+    }
+
+    /**
+     * Report a warning for the current line. Nodes report problems 
+     * which don't stop them from assembling here rather than throwing,
+     * so sources with many warnings don't pay for unwinding each one.
+     */
+    void Pass::warning(const string &message)
+    {
+        pushMessage(Message{ true, line_, message });
+    }
+
+    /**
+     * Report an error for the current line, and carry on assembling
+     * the node.
+     */
+    void Pass::error(const string &message)
+    {
+        pushMessage(Message{ false, line_, message });
+    }
+
     /**
      * Push a warning or error message ont the error list.
      */
@@ -138,23 +166,6 @@ namespace yas6502
         messages_.push_back(msg);
     }
 
-    /**
-     * Look up an opcode in the opcode map. Case insensitive.
-     * Returns nullptr if there is no such opcode.
-     */
-    const opcodes::Instruction &Pass::findInstruction(const string &op)
-    {
-        auto it = opcodes_.find(toUpper(op));
-        if (it == opcodes_.end()) {
-            ss err{};
-            err
-                << "Unknown opcode `" << op << "'.";
-            throw Error{ err.str() };
-        }
-
-        return it->second;
-    }
-
     /**
      * Return the symbol table.
      */
@@ -52,15 +52,17 @@ namespace yas6502
     class Pass
     {
     public:
-        Pass(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes);
+        Pass(SymbolTable &symtab);
         virtual ~Pass();
 
         SymbolTable &symtab();
-        const opcodes::Instruction &findInstruction(const std::string &op);
 
         int loc() const;
         void setLoc(int loc);
 
+        void setLine(int line);
+        void warning(const std::string &message);
+        void error(const std::string &message);
         void pushMessage(const Message &msg);
 
         int warnings() const;
@@ -69,8 +71,8 @@ namespace yas6502
 
     protected:
         SymbolTable &symtab_;
-        const opcodes::OpcodeMap &opcodes_;
         int loc_;
+        int line_;
         int errors_;
         int warnings_;
         std::vector<Message> messages_;
@@ -37,7 +37,6 @@
 using std::cerr;
 using std::endl;
 using std::string;
-using std::unique_ptr;
 using std::vector;
 
 using ss = std::stringstream;
@@ -47,29 +46,48 @@ namespace yas6502
     /**
      * Constructor
      */
-    Pass1::Pass1(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes)
-        : Pass(symtab, opcodes)
+    Pass1::Pass1(SymbolTable &symtab)
+        : Pass(symtab)
+        , deferredSets_(0)
     {
     }
 
     /**
-     * Execute pass1. This pass just computes location counter values,
-     * defines symbols, and reports basic errors. Actual code generation
-     * happens in pass 2.
+     * Run pass 1 on one node. This pass just computes location counter
+     * values, defines symbols, and reports basic errors. Actual code
+     * generation happens in pass 2.
      */
-    void Pass1::pass1(vector<unique_ptr<ast::Node>> &ast)
+    void Pass1::pass1(ast::Node *node)
     {
-        for (auto &node : ast) {
-            try {
-                node->setLoc(loc_);
-                node->pass1(*this);
-            } catch (Error &ex) {
-                bool warning = ex.type() == ErrorType::Warning;
-                pushMessage(Message{ warning, node->line(), ex.message() });
-            }
+        setLine(node->line());
+
+        try {
+            node->setLoc(loc_);
+            node->pass1(*this);
+        } catch (Error &ex) {
+            bool warning = ex.type() == ErrorType::Warning;
+            pushMessage(Message{ warning, node->line(), ex.message() });
         }
     }
 
+    /**
+     * Note a SET whose value can't be known until pass 2. 
+     */
+    void Pass1::deferSet()
+    {
+        deferredSets_++;
+    }
+
+    /**
+     * Return the number of SETs left for pass 2 to define. If there
+     * are any, symbols change during pass 2, so its nodes must be 
+     * assembled in order.
+     */
+    int Pass1::deferredSets() const
+    {
+        return deferredSets_;
+    }
+
     namespace ast
     {
         /**
@@ -78,7 +96,7 @@ namespace yas6502
          */
         void Node::pass1(Pass1 &pass1)
         {
-            if (label_.empty()) {
+            if (label_ == NO_SYMBOL) {
                 return;
             }
 
@@ -92,14 +110,14 @@ namespace yas6502
         {
             Node::pass1(pass1);
 
-            ExprResult er = locExpr_->eval(pass1);
+            ExprResult er = locExpr_.eval(pass1);
             if (!er.defined()) {
                ss err{};
                err
                    << "ORG expression must be fully defined in pass1, but contains undefined symbols '"
-                   << concatSet(er.undefinedSymbols(), "', '")
+                   << concatSet(er.undefinedSymbols(pass1.symtab(), locExpr_), "', '")
                    << "'.";
-                pass1.pushMessage(Message{ false, line(), err.str() });
+                pass1.error(err.str());
             }
 
             computedLoc_ = er.value();
@@ -115,8 +133,9 @@ namespace yas6502
 
             // It's ok for a symbol to not be fully defined in pass 1.
             // 
-            ExprResult er = value_->eval(pass1);
+            ExprResult er = value_.eval(pass1);
             if (!er.defined()) {
+                pass1.deferSet();
                 return;
             }
             pass1.symtab().setValue(symbol_, er.value());
@@ -129,12 +148,8 @@ namespace yas6502
         {
             Node::pass1(pass1);
 
-            if (address_->addressExpr() != nullptr && address_->addressExpr()->parenthesized()) {
-                pass1.pushMessage(Message{ 
-                    true, 
-                    line(), 
-                    "Top level expression is parenthesized, did you mean to use brackets for indirect addressing?"
-                });
+            if (address_.addressExpr() != nullptr && address_.addressExpr()->parenthesized()) {
+                pass1.warning("Top level expression is parenthesized, did you mean to use brackets for indirect addressing?");
             }
 
             // for an instruction, we need to update the location
@@ -149,10 +164,11 @@ namespace yas6502
             
             int size = 0;
             ExprResult er{ 1 };
+            bool evaluated = false;
             
-            const auto &instr = pass1.findInstruction(opcode_);
+            const auto &instr = instruction_;
 
-            switch (address_->mode()) {
+            switch (address_.mode()) {
             case AddrMode::Implied:
             case AddrMode::Accumulator:
                 size = 1;
@@ -175,7 +191,8 @@ namespace yas6502
                 // and must have a fully defined operand that fits in
                 // one byte.
                 if (instr.hasEncoding(opcodes::AddrMode::ZeroPage)) {
-                    er = address_->addressExpr()->eval(pass1);
+                    er = address_.addressExpr()->eval(pass1);
+                    evaluated = true;
                     if (er.defined() && er.value() >= 0 && er.value() <= 0xFF) {
                         size = 2;
                     }
@@ -191,11 +208,12 @@ namespace yas6502
                     size = 3;
 
                     bool hasZeroPage =
-                        (address_->mode() == AddrMode::AddressX && instr.hasEncoding(opcodes::AddrMode::ZeroPageX)) ||
-                        (address_->mode() == AddrMode::AddressY && instr.hasEncoding(opcodes::AddrMode::ZeroPageY));
+                        (address_.mode() == AddrMode::AddressX && instr.hasEncoding(opcodes::AddrMode::ZeroPageX)) ||
+                        (address_.mode() == AddrMode::AddressY && instr.hasEncoding(opcodes::AddrMode::ZeroPageY));
 
                     if (hasZeroPage) {
-                        er = address_->addressExpr()->eval(pass1);
+                        er = address_.addressExpr()->eval(pass1);
+                        evaluated = true;
                         if (er.defined() && er.value() >= 0 && er.value() <= 0xFF) {
                             size = 2;
                         }
@@ -221,9 +239,34 @@ namespace yas6502
                 operandSize_ = DataSize::Byte;
             }
 
+            // Keep a fully defined operand's value so pass 2 doesn't have
+            // to evaluate it again.
+            //
+            if (evaluated) {
+                operandKnown_ = er.defined();
+                operand_ = er.value();
+            } else if (address_.addressExpr() != nullptr) {
+                cacheOperand(pass1);
+            }
+
             pass1.setLoc(pass1.loc() + size);
         }
 
+        /**
+         * Evaluate an operand that wasn't needed to size the instruction, 
+         * and keep its value if it's fully defined. 
+         */
+        void InstructionNode::cacheOperand(Pass1 &pass1)
+        {
+            try {
+                ExprResult er = address_.addressExpr()->eval(pass1);
+                operandKnown_ = er.defined();
+                operand_ = er.value();
+            } catch (Error &) {
+                // Pass 2 will evaluate it again and report the error.
+            }
+        }
+
         /**
          * Data nodes stores bytes or words.
          */
@@ -231,27 +274,32 @@ namespace yas6502
         {
             Node::pass1(pass1);
 
+            if (packed_.data != nullptr) {
+                pass1.setLoc(pass1.loc() + static_cast<int>(packed_.size()));
+                return;
+            }
+
             // in pass 1, all we need to do is update the location
             // counter.
             //
             int size = (size_ == DataSize::Byte) ? 1 : 2;
 
             int elements = 0;
-            for (const auto &de : data_) {
+            for (const DataElement &de : data_) {
                 int count = 1;
-                if (de->count != nullptr) {
-                    ExprResult er = de->count->eval(pass1);
+                if (!de.count.empty()) {
+                    ExprResult er = de.count.eval(pass1);
                     if (!er.defined()) {
                         ss err{};
                         err 
                             << "REP count expression must be fully defined in pass 1, but contains undefined symbols '"
-                            << concatSet(er.undefinedSymbols(), "', '")
+                            << concatSet(er.undefinedSymbols(pass1.symtab(), de.count), "', '")
                             << "'.";
-                        pass1.pushMessage(Message{ false, line(), err.str() });
+                        pass1.error(err.str());
                         continue;
                     }
                     if (er.value() < 1) {
-                        pass1.pushMessage(Message{ false, line(), "REP count expression must be positive." });
+                        pass1.error("REP count expression must be positive.");
                         continue;
                     }
                     count = er.value();
@@ -269,14 +317,14 @@ namespace yas6502
         void SpaceNode::pass1(Pass1 &pass1)
         {
             int size = (size_ == DataSize::Byte) ? 1 : 2;
-            ExprResult er = count_->eval(pass1);
+            ExprResult er = count_.eval(pass1);
             if (!er.defined()) {
                ss err{};
                err
                    << "SPACE expression must be fully defined in pass 1, but contains undefined symbols '"
-                   << concatSet(er.undefinedSymbols(), "', '")
+                   << concatSet(er.undefinedSymbols(pass1.symtab(), count_), "', '")
                    << "'.";
-                pass1.pushMessage(Message{ false, line(), err.str() });
+                pass1.error(err.str());
             }
 
             pass1.setLoc(pass1.loc() + size * er.value());
@@ -40,8 +40,14 @@ namespace yas6502
     class Pass1 : public Pass
     {
     public:
-        Pass1(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes);
-        void pass1(std::vector<std::unique_ptr<ast::Node>> &ast);
+        Pass1(SymbolTable &symtab);
+        void pass1(ast::Node *node);
+
+        void deferSet();
+        int deferredSets() const;
+
+    private:
+        int deferredSets_;
     };
 }
 
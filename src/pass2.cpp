@@ -26,16 +26,19 @@
 #include "symtab.h"
 #include "utility.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
-using std::array;
 using std::cerr;
 using std::endl;
+using std::make_unique;
 using std::string;
 using std::unique_ptr;
 using std::vector;
@@ -47,36 +50,173 @@ namespace yas6502
     /**
      * Constructor
      */
-    Pass2::Pass2(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes)
-        : Pass(symtab, opcodes)
+    Pass2::Pass2(SymbolTable &symtab)
+        : Pass(symtab)
+        , undefined_(false)
     {
     }
 
     /**
      * Execute pass2. This pass verifies that all symbols are fully defined 
      * and builds the in-memory object image.
+     *
+     * With more than one job, the program is split into ranges which 
+     * are assembled on their own threads, each into its own image. The
+     * caller must only allow this if the symbol table is final, so the
+     * SETs in pass 2 just check their values. Every range after the first
+     * starts with an ORG that doesn't depend on the location counter, so
+     * it starts at the same location it would in order. The images are 
+     * merged in order, so if ranges overlap the later one wins, and the 
+     * messages are appended in order.
      */
-    void Pass2::pass2(vector<unique_ptr<ast::Node>> &ast)
+    void Pass2::pass2(vector<ast::Node *> &ast, int jobs)
     {
         loc_ = 0;
-        std::fill(image_.begin(), image_.end(), -1);
-
-        for (auto &node : ast) {
-            try {
-                node->pass2(*this);
-                node->setNextLoc(loc_);
-            } catch (Error &ex) {
-                bool warning = ex.type() == ErrorType::Warning;
-                pushMessage(Message{ warning, node->line(), ex.message() });
+        image_.clear();
+
+        vector<size_t> starts = splitRanges(ast, jobs);
+        starts.push_back(ast.size());
+
+        vector<unique_ptr<Pass2>> ranges{};
+        vector<std::thread> threads{};
+        for (size_t i = 1; i + 1 < starts.size(); i++) {
+            ranges.push_back(make_unique<Pass2>(symtab_));
+            threads.emplace_back(&Pass2::pass2Range, ranges.back().get(), std::ref(ast), starts[i], starts[i + 1]);
+        }
+
+        pass2Range(ast, starts[0], starts[1]);
+
+        for (size_t i = 0; i < ranges.size(); i++) {
+            threads[i].join();
+
+            const Pass2 &range = *ranges[i];
+            image_.merge(range.image_);
+            for (const Message &msg : range.messages()) {
+                pushMessage(msg);
+            }
+            loc_ = range.loc_;
+        }
+    }
+
+    /**
+     * Return where the ranges for `jobs' threads start. Ranges are
+     * only worth a thread if they're long, and can only start at a 
+     * node which fixes the location counter.
+     */
+    vector<size_t> Pass2::splitRanges(const vector<ast::Node *> &ast, int jobs) const
+    {
+        const size_t MIN_RANGE = 4096;
+
+        vector<size_t> starts{ 0 };
+        if (jobs <= 1) {
+            return starts;
+        }
+
+        size_t perRange = std::max(MIN_RANGE, ast.size() / jobs);
+        for (size_t i = 1; i < ast.size(); i++) {
+            if (i - starts.back() >= perRange && ast[i]->fixesLocation()) {
+                starts.push_back(i);
+            }
+        }
+
+        return starts;
+    }
+
+    /**
+     * Assemble the nodes from `begin' up to `end'.
+     */
+    void Pass2::pass2Range(vector<ast::Node *> &ast, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) {
+            pass2(ast[i]);
+        }
+    }
+
+    /**
+     * Run pass 2 on one node.
+     */
+    void Pass2::pass2(ast::Node *node)
+    {
+        setLine(node->line());
+
+        try {
+            node->pass2(*this);
+            node->setNextLoc(loc_);
+        } catch (Error &ex) {
+            bool warning = ex.type() == ErrorType::Warning;
+            pushMessage(Message{ warning, node->line(), ex.message() });
+        }
+    }
+
+    /**
+     * For single pass assembly, emit a node as soon as pass 1 has
+     * placed it. The location counter carries on from the previous 
+     * node, as it does in two pass mode. If the node refers to a symbol 
+     * that isn't defined yet, nothing is reported and false is returned;
+     * the `size' bytes pass 1 gave it are left for it, and it must be
+     * kept and given to fixup() once all symbols are defined. Any bytes 
+     * it emitted before finding the symbol will be written again, and 
+     * anything it reported before then will be reported again.
+     */
+    bool Pass2::emitNow(ast::Node *node, int size)
+    {
+        int loc = loc_;
+        setLine(node->line());
+        undefined_ = false;
+
+        size_t messages = messages_.size();
+        int errors = errors_;
+        int warnings = warnings_;
+
+        try {
+            node->pass2(*this);
+            node->setNextLoc(loc_);
+        } catch (Error &ex) {
+            if (undefined_) {
+                messages_.resize(messages);
+                errors_ = errors;
+                warnings_ = warnings;
+
+                node->setLoc(loc);
+                loc_ = loc + size;
+                return false;
             }
+
+            bool warning = ex.type() == ErrorType::Warning;
+            pushMessage(Message{ warning, node->line(), ex.message() });
+        }
+
+        return true;
+    }
+
+    /**
+     * For single pass assembly, emit a node that referred to symbols 
+     * which were not yet defined when it was placed, in the `reserved'
+     * bytes left for it. The nodes after it have already been placed, so
+     * it's an error if it doesn't fill exactly that many bytes.
+     */
+    void Pass2::fixup(ast::Node *node, int reserved)
+    {
+        int errors = errors_;
+
+        loc_ = node->loc();
+        pass2(node);
+
+        int size = loc_ - node->loc();
+        if (errors_ == errors && size != reserved) {
+            ss err{};
+            err
+                << "In single pass mode, this assembled to " << size
+                << " byte(s) once its symbols were defined, but " << reserved
+                << " were left for it; assemble it in two pass mode.";
+            error(err.str());
         }
     }
 
     /**
-     * Returns the assembled image. Bytes which have no data
-     * are marked with -1.
+     * Returns the assembled image.
      */
-    const array<int, 65536> &Pass2::image() const
+    const Image &Pass2::image() const
     {
         return image_;
     }
@@ -97,7 +237,53 @@ namespace yas6502
             throw Error{ err.str() };
         }
 
-        image_[loc_++] = byte & 0xFF;
+        image_.set(loc_++, byte & 0xFF);
+    }
+
+    /**
+     * Add `length' bytes from `data' to the image at the current 
+     * location counter, and move the location counter past them. 
+     * Like emitting the bytes one at a time, whatever fits in memory 
+     * is stored before the range error is thrown.
+     */
+    void Pass2::emit(const uint8_t *data, int length)
+    {
+        int fits = room(length);
+        image_.set(loc_, data, fits);
+        loc_ += fits;
+
+        if (fits < length) {
+            emit(data[fits]);
+        }
+    }
+
+    /**
+     * Add `count' copies of the `patternLength' bytes of `pattern' to 
+     * the image at the current location counter, and move the location
+     * counter past them.
+     */
+    void Pass2::fill(const uint8_t *pattern, int patternLength, int count)
+    {
+        int length = patternLength * count;
+        int fits = room(length);
+        image_.fill(loc_, pattern, patternLength, fits);
+        loc_ += fits;
+
+        if (fits < length) {
+            emit(pattern[fits % patternLength]);
+        }
+    }
+
+    /**
+     * Return how many of `length' bytes fit in memory at the current
+     * location counter.
+     */
+    int Pass2::room(int length) const
+    {
+        if (loc_ < 0) {
+            return 0;
+        }
+        return std::max(0, std::min(length, 0x10000 - loc_));
     }
 
     /**
@@ -105,15 +291,17 @@ namespace yas6502
      * if there are any undefined symbols; else return the
      * integer value of the expression.
      */
-    int Pass2::evalCheckDefined(ast::Expression &expr)
+    int Pass2::evalCheckDefined(const ast::Expression &expr)
     {
         ast::ExprResult er = expr.eval(*this);
         if (!er.defined()) {
+            undefined_ = true;
+
             // All symbols must be fully defined in pass 2.
             ss err{};
             err
                 << "Symbols '"
-                << concatSet(er.undefinedSymbols(), "', '")
+                << concatSet(er.undefinedSymbols(symtab_, expr), "', '")
                 << "' are undefined in instruction operand.";
             throw Error{ err.str() };
         }
@@ -122,7 +310,7 @@ namespace yas6502
 
     /**
      * Check that the given value is in the range of a signed
-     * or unsigned byte.
+     * or unsigned byte, and warn if it isn't.
      */ 
     void Pass2::checkByte(int value)
     {
@@ -135,7 +323,7 @@ namespace yas6502
             << "Operand value "
             << value
             << " should fit in one byte; truncated.";
-            throw Error{ err.str(), ErrorType::Warning };
+        warning(err.str());
     }
 
     namespace ast
@@ -154,7 +342,7 @@ namespace yas6502
         {
             Node::pass2(pass2);
 
-            int value = pass2.evalCheckDefined(*locExpr_);
+            int value = pass2.evalCheckDefined(locExpr_);
             
             // The expression was fully defined in pass 1, 
             // so sanity check that it hasn't changed.
@@ -174,7 +362,7 @@ namespace yas6502
 
             // NB the symbol table will throw an error if the value
             // unexpectedly changed.
-            pass2.symtab().setValue(symbol_, pass2.evalCheckDefined(*value_));
+            pass2.symtab().setValue(symbol_, pass2.evalCheckDefined(value_));
         }
 
         namespace
@@ -224,6 +412,19 @@ namespace yas6502
             }
         }
 
+        /**
+         * Return the value of the operand. If it was fully defined in 
+         * pass 1 and the location counter is where it was then, it can't 
+         * have changed, so it isn't evaluated again.
+         */
+        int InstructionNode::operandValue(Pass2 &pass2) const
+        {
+            if (operandKnown_ && pass2.loc() == loc_) {
+                return operand_;
+            }
+            return pass2.evalCheckDefined(*address_.addressExpr());
+        }
+
         /**
          * Pass 2 for an instruction
          */
@@ -236,7 +437,7 @@ namespace yas6502
             // just enough to determine relative branches and if zero page was
             // an option, so we have to check available address mode encodings here.
             //
-            const opcodes::Instruction &instr = pass2.findInstruction(opcode_);
+            const opcodes::Instruction &instr = instruction_;
 
             int value = 0;
 
@@ -245,7 +446,7 @@ namespace yas6502
 
             // TODO I'm not a fan of this big switch nor the matching
             // one in pass 1.
-            switch (address_->mode()) {
+            switch (address_.mode()) {
             case AddrMode::Implied:
                 enc = &ensureEncoding(instr, opcodes::AddrMode::Implied);
                 pass2.emit(enc->opcode());
@@ -257,19 +458,17 @@ namespace yas6502
                 break;
 
             case AddrMode::Immediate:
-                value = pass2.evalCheckDefined(*address_->addressExpr());
+                value = operandValue(pass2);
                 enc = &ensureEncoding(instr, opcodes::AddrMode::Immediate);
                 pass2.emit(enc->opcode());
                 pass2.emit(value);
 
-                // NB do this checks after emit() because they throw
-                // a warning so we want assembly to still succeed
                 pass2.checkByte(value);
                 break;
 
             case AddrMode::Address:
                 {
-                    value = pass2.evalCheckDefined(*address_->addressExpr());
+                    value = operandValue(pass2);
                     if (instr.hasEncoding(opcodes::AddrMode::Relative)) {
                         enc = &instr.encoding(opcodes::AddrMode::Relative);
 
@@ -279,7 +478,7 @@ namespace yas6502
                         pass2.emit(delta);
 
                         if (delta < -128 || delta > 127) {
-                            throw Error{ "Relative branch is out of range." };
+                            pass2.error("Relative branch is out of range.");
                         }
                         break;
                     }
@@ -301,8 +500,8 @@ namespace yas6502
             case AddrMode::AddressX:
             case AddrMode::AddressY:
                 {
-                    value = pass2.evalCheckDefined(*address_->addressExpr());
-                    bool isX = address_->mode() == AddrMode::AddressX;
+                    value = operandValue(pass2);
+                    bool isX = address_.mode() == AddrMode::AddressX;
                     unsigned op = -1;
 
                     // This whole bit of logic is unfortunately complex.
@@ -360,7 +559,7 @@ namespace yas6502
                 break;
 
             case AddrMode::Indirect:
-                value = pass2.evalCheckDefined(*address_->addressExpr());
+                value = operandValue(pass2);
                 enc = &ensureEncoding(instr, opcodes::AddrMode::Indirect);
                 pass2.emit(enc->opcode());
                 pass2.emit(value & 0xFF);
@@ -370,19 +569,19 @@ namespace yas6502
             case AddrMode::IndirectX:
             case AddrMode::IndirectY:
                 int op = -1;
-                if (address_->mode() == AddrMode::IndirectX) {
+                if (address_.mode() == AddrMode::IndirectX) {
                     enc = &ensureEncoding(instr, opcodes::AddrMode::IndirectX);
                 } else {
                     enc = &ensureEncoding(instr, opcodes::AddrMode::IndirectY);
                 }
 
-                value = pass2.evalCheckDefined(*address_->addressExpr());
+                value = operandValue(pass2);
 
                 pass2.emit(enc->opcode());
                 pass2.emit(value & 0xFF);
 
                 if (value < 0 || value > 0xFF) {
-                    throw Error{ "Address is not in zero page." };
+                    pass2.error("Address is not in zero page.");
                 }
                 break;
             }
@@ -402,23 +601,33 @@ namespace yas6502
         {
             Node::pass2(pass2);
 
-            for (const auto &ele : data_) {
+            // Packed constants all fit, so there's nothing to check.
+            //
+            if (packed_.data != nullptr) {
+                pass2.emit(packed_.data, static_cast<int>(packed_.size()));
+                return;
+            }
+
+            for (const DataElement &ele : data_) {
                 int count =1;
 
-                if (ele->count != nullptr) {
-                    count = pass2.evalCheckDefined(*ele->count);
+                if (!ele.count.empty()) {
+                    count = pass2.evalCheckDefined(ele.count);
                 }
-                int value = pass2.evalCheckDefined(*ele->value);
+                int value = pass2.evalCheckDefined(ele.value);
 
                 // NB pass 1 errors if count is not positive.
                 //
-                while (count--) {
-                    pass2.emit(value & 0xFF);
-                    if (size_ == DataSize::Byte) {
-                        pass2.checkByte(value);
-                    } else {
-                        pass2.emit(value >> 8);
-                    }
+                if (size_ == DataSize::Byte) {
+                    uint8_t byte = value & 0xFF;
+                    pass2.checkByte(value);
+                    pass2.fill(&byte, 1, count);
+                } else {
+                    uint8_t word[2] = { 
+                        static_cast<uint8_t>(value & 0xFF), 
+                        static_cast<uint8_t>((value >> 8) & 0xFF) 
+                    };
+                    pass2.fill(word, 2, count);
                 }
             } 
         }
@@ -429,7 +638,7 @@ namespace yas6502
         void SpaceNode::pass2(Pass2 &pass2)
         {
             int size = (size_ == DataSize::Byte) ? 1 : 2;
-            ExprResult er = count_->eval(pass2);
+            ExprResult er = count_.eval(pass2);
             // expression defined is forced in pass 1
             pass2.setLoc(pass2.loc() + size * er.value());
         }
@@ -439,9 +648,7 @@ namespace yas6502
          */
         void StringNode::pass2(Pass2 &pass2)
         {
-            for (char s : str_) {
-                pass2.emit(s);
-            }
+            pass2.emit(reinterpret_cast<const uint8_t *>(str_.data), static_cast<int>(str_.size()));
 
             if (nulTerminate_) {
                 pass2.emit('\0');
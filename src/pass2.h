@@ -23,10 +23,10 @@
 #define PASS2_H_
 
 #include "ast.h"
+#include "image.h"
 #include "pass.h"
 #include "opcodes.h"
 
-#include <array>
 #include <memory>
 #include <vector>
 
@@ -37,23 +37,28 @@ namespace yas6502
     class Pass2 : public Pass
     {
     public:
-        Pass2(SymbolTable &symtab, const opcodes::OpcodeMap &opcodes);
-        void pass2(std::vector<std::unique_ptr<ast::Node>> &ast);
+        Pass2(SymbolTable &symtab);
+        void pass2(std::vector<ast::Node *> &ast, int jobs);
+        bool emitNow(ast::Node *node, int size);
+        void fixup(ast::Node *node, int reserved);
         
-        const std::array<int, 65536> &image() const;
+        const Image &image() const;
 
         // Interface for use by AST nodes assembling themselves
         void emit(unsigned byte);
-        int evalCheckDefined(ast::Expression &expr);
+        void emit(const uint8_t *data, int length);
+        void fill(const uint8_t *pattern, int patternLength, int count);
+        int evalCheckDefined(const ast::Expression &expr);
         void checkByte(int value);
 
     private:
-        // the address space of a 16-bit processor is so small that
-        // it makes sense to just keep an image of all of memory
-        // rather than try to build individual OMF records as we
-        // would if the assembler was self-hosted.
-        //
-        std::array<int, 65536> image_;
+        std::vector<size_t> splitRanges(const std::vector<ast::Node *> &ast, int jobs) const;
+        void pass2Range(std::vector<ast::Node *> &ast, size_t begin, size_t end);
+        void pass2(ast::Node *node);
+        int room(int length) const;
+
+        Image image_;
+        bool undefined_;
     };
 }
 
@@ -0,0 +1,409 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "assembler.h"
+
+#include "except.h"
+#include "parser.h"
+#include "scanner.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::ifstream;
+using std::string;
+using std::vector;
+
+using ss = std::stringstream;
+
+using yas6502::Assembler;
+using yas6502::ScannerType;
+
+namespace
+{
+    struct Run {
+        long tokens = 0;
+        long errors = 0;
+        double milliseconds = 0.0;
+    };
+
+    void usage();
+    ScannerType scannerType(const string &name);
+    vector<char> readSource(const string &filename);
+    Run scan(ScannerType type, const vector<char> &source, int repeat);
+    vector<string> tokens(ScannerType type, const vector<char> &source);
+    string describe(const yy::parser::symbol_type &token, const Assembler &asmb);
+    string describe(const yy::parser::syntax_error &error);
+    string position(const yy::location &loc);
+    string quote(const yas6502::Text &text);
+    bool compare(const string &filename, const vector<char> &source);
+    void report(const string &filename, const char *scanner, size_t bytes, int repeat, const Run &run);
+}
+
+/**
+ * Time the scanners on their own, without parsing, over each of the
+ * given source files. With -d, print the tokens one scanner finds
+ * instead, and with -c, check that both scanners find the same tokens
+ * at the same locations.
+ */
+int main(int argc, char *argv[])
+{
+    int repeat = 10;
+    bool dump = false;
+    bool check = false;
+    ScannerType dumpType = ScannerType::Table;
+    int ch;
+
+    while ((ch = getopt(argc, argv, "n:d:c")) != -1) {
+        switch (ch) {
+        case 'n':
+            repeat = atoi(optarg);
+            if (repeat < 1) {
+                usage();
+            }
+            break;
+
+        case 'd':
+            dump = true;
+            dumpType = scannerType(optarg);
+            break;
+
+        case 'c':
+            check = true;
+            break;
+
+        default:
+            usage();
+        }
+    }
+
+    if (optind >= argc || (dump && check)) {
+        usage();
+    }
+
+    bool failed = false;
+    for (int i = optind; i < argc; i++) {
+        string filename{ argv[i] };
+
+        try {
+            vector<char> source = readSource(filename);
+
+            if (dump) {
+                for (const string &token : tokens(dumpType, source)) {
+                    cout << token << endl;
+                }
+                continue;
+            }
+
+            if (check) {
+                failed = !compare(filename, source) || failed;
+                continue;
+            }
+
+            report(filename, "table", source.size(), repeat, scan(ScannerType::Table, source, repeat));
+
+            try {
+                report(filename, "flex", source.size(), repeat, scan(ScannerType::Flex, source, repeat));
+            } catch (yas6502::Error &ex) {
+                cout << filename << ": flex: " << ex.message() << endl;
+            }
+        } catch (yas6502::Error &ex) {
+            cerr << ex.message() << endl;
+            failed = true;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+namespace
+{
+    /**
+     * Print usage and exit
+     */
+    void usage()
+    {
+        cerr
+            << "yas6502-scanbench: [-n repeat] [-d table|flex] [-c] source-file..."
+            << endl;
+        exit(1);
+    }
+
+    /**
+     * Return the scanner type named on the command line.
+     */
+    ScannerType scannerType(const string &name)
+    {
+        if (name == "table") {
+            return ScannerType::Table;
+        }
+        if (name == "flex") {
+            return ScannerType::Flex;
+        }
+        usage();
+        return ScannerType::Table;
+    }
+
+    /**
+     * Read a whole source file.
+     */
+    vector<char> readSource(const string &filename)
+    {
+        ifstream inp{ filename, std::ios::in | std::ios::binary };
+        if (!inp) {
+            ss err{};
+            err
+                << "Could not open source file `"
+                << filename
+                << "' for read.";
+            throw yas6502::Error{ err.str() };
+        }
+
+        return vector<char>{ std::istreambuf_iterator<char>(inp), std::istreambuf_iterator<char>() };
+    }
+
+    /**
+     * Scan `source' to the end `repeat' times. Each time starts over with 
+     * a fresh copy of the source, as the flex scanner writes to it, and a 
+     * fresh assembler for the scanner to intern symbols into. Invalid
+     * characters are counted, and scanning carries on after them.
+     */
+    Run scan(ScannerType type, const vector<char> &source, int repeat)
+    {
+        Run run{};
+
+        for (int i = 0; i < repeat; i++) {
+            vector<char> buffer{ source };
+            buffer.push_back(0);
+            buffer.push_back(0);
+
+            Assembler asmb{};
+            auto scanner = yas6502::makeScanner(type, buffer.data(), source.size(), false);
+
+            auto start = std::chrono::steady_clock::now();
+            for (;;) {
+                try {
+                    yy::parser::symbol_type token = scanner->next(asmb);
+                    if (token.kind() == yy::parser::symbol_kind::S_YYEOF) {
+                        break;
+                    }
+                    run.tokens++;
+                } catch (yy::parser::syntax_error &) {
+                    run.errors++;
+                }
+            }
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            run.milliseconds += elapsed.count();
+        }
+
+        run.tokens /= repeat;
+        run.errors /= repeat;
+        return run;
+    }
+
+    /**
+     * Scan `source' once, and describe each token and invalid character
+     * found, up to and including the end of the file.
+     */
+    vector<string> tokens(ScannerType type, const vector<char> &source)
+    {
+        vector<char> buffer{ source };
+        buffer.push_back(0);
+        buffer.push_back(0);
+
+        Assembler asmb{};
+        auto scanner = yas6502::makeScanner(type, buffer.data(), source.size(), false);
+
+        vector<string> found{};
+        for (;;) {
+            try {
+                yy::parser::symbol_type token = scanner->next(asmb);
+                found.push_back(describe(token, asmb));
+                if (token.kind() == yy::parser::symbol_kind::S_YYEOF) {
+                    break;
+                }
+            } catch (yy::parser::syntax_error &ex) {
+                found.push_back(describe(ex));
+            }
+        }
+
+        return found;
+    }
+
+    /**
+     * Describe a token: its location, its kind, and its value if it 
+     * has one.
+     */
+    string describe(const yy::parser::symbol_type &token, const Assembler &asmb)
+    {
+        using kind = yy::parser::symbol_kind;
+
+        ss out{};
+        out << position(token.location) << " " << token.name();
+
+        switch (token.kind()) {
+        case kind::S_NUMBER:
+            out << " " << token.value.as<int>();
+            break;
+
+        case kind::S_IDENTIFIER:
+            out << " " << asmb.symtab().spelling(token.value.as<int>());
+            break;
+
+        case kind::S_OPCODE:
+            {
+                const yas6502::ast::Opcode &opcode = token.value.as<yas6502::ast::Opcode>();
+                out
+                    << " " << yas6502::opcodes::mnemonicName(opcode.mnemonic)
+                    << " " << quote(opcode.spelling);
+            }
+            break;
+
+        case kind::S_STRING:
+        case kind::S_COMMENT:
+            out << " " << quote(token.value.as<yas6502::Text>());
+            break;
+
+        default:
+            break;
+        }
+
+        return out.str();
+    }
+
+    /**
+     * Describe an invalid character.
+     */
+    string describe(const yy::parser::syntax_error &error)
+    {
+        return position(error.location) + " error " + error.what();
+    }
+
+    /**
+     * Format a location as line.column-line.column.
+     */
+    string position(const yy::location &loc)
+    {
+        ss out{};
+        out 
+            << loc.begin.line << "." << loc.begin.column << "-" 
+            << loc.end.line << "." << loc.end.column;
+        return out.str();
+    }
+
+    /**
+     * Quote the text of a token, escaping anything which isn't printable.
+     */
+    string quote(const yas6502::Text &text)
+    {
+        ss out{};
+        out << '"';
+
+        for (char ch : text) {
+            switch (ch) {
+            case '\n':
+                out << "\\n";
+                break;
+
+            case '\r':
+                out << "\\r";
+                break;
+
+            case '"':
+            case '\\':
+                out << '\\' << ch;
+                break;
+
+            default:
+                if (ch < ' ' || ch > '~') {
+                    out 
+                        << "\\x" << std::hex << std::setw(2) << std::setfill('0') 
+                        << (static_cast<unsigned>(ch) & 0xFF) << std::dec;
+                } else {
+                    out << ch;
+                }
+            }
+        }
+
+        out << '"';
+        return out.str();
+    }
+
+    /**
+     * Scan `source' with both scanners, and report the first token where
+     * they differ, if there is one. Returns true if they found the same
+     * tokens.
+     */
+    bool compare(const string &filename, const vector<char> &source)
+    {
+        vector<string> table = tokens(ScannerType::Table, source);
+        vector<string> flex = tokens(ScannerType::Flex, source);
+
+        size_t i = 0;
+        while (i < table.size() && i < flex.size() && table[i] == flex[i]) {
+            i++;
+        }
+
+        if (i == table.size() && i == flex.size()) {
+            cout << filename << ": " << table.size() << " tokens are the same." << endl;
+            return true;
+        }
+
+        cout 
+            << filename << ": token " << i + 1 << " differs." << endl
+            << "  table: " << (i < table.size() ? table[i] : "(none)") << endl
+            << "  flex:  " << (i < flex.size() ? flex[i] : "(none)") << endl;
+        return false;
+    }
+
+    /**
+     * Print the results for one scanner on one file.
+     */
+    void report(const string &filename, const char *scanner, size_t bytes, int repeat, const Run &run)
+    {
+        double milliseconds = run.milliseconds / repeat;
+        double megabytes = bytes / (1024.0 * 1024.0);
+
+        cout
+            << filename << ": "
+            << std::left << std::setw(6) << scanner << std::right
+            << std::setw(10) << run.tokens << " tokens "
+            << std::setw(6) << run.errors << " errors "
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << milliseconds << " ms "
+            << std::setprecision(1)
+            << std::setw(8) << (milliseconds > 0 ? megabytes * 1000.0 / milliseconds : 0.0) << " MB/s"
+            << endl;
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "scanner.h"
+
+#include "except.h"
+
+using std::make_unique;
+using std::unique_ptr;
+
+namespace yas6502
+{
+    /**
+     * Destructor
+     */
+    Scanner::~Scanner()
+    {
+    }
+
+    /**
+     * Make a scanner of the given type over `source', which must be
+     * followed by two NUL bytes (i.e. the buffer must be at least 
+     * `length' + 2 bytes long). The flex scanner is only there if
+     * flex was found when the library was built.
+     */
+    unique_ptr<Scanner> makeScanner(ScannerType type, char *source, size_t length, bool trace)
+    {
+        switch (type) {
+        case ScannerType::Table:
+            break;
+
+        case ScannerType::Flex:
+#ifdef YAS6502_HAVE_FLEX
+            return make_unique<FlexScanner>(source, length, trace);
+#else
+            throw Error{ "This build does not include the flex scanner." };
+#endif
+        }
+
+        return make_unique<TableScanner>(source, length);
+    }
+}
@@ -22,10 +22,76 @@
 #ifndef SCANNER_H_
 #define SCANNER_H_
 
+#include "parser.tab.hpp"
+
+#include <cstddef>
+#include <memory>
+
 namespace yas6502
 {
-    extern void cleanUpScanner();
+    class Assembler;
+
+    enum class ScannerType
+    {
+        Table,
+        Flex,
+    };
+
+    /**
+     * The source of tokens for one parse. Each parse owns its own
+     * scanner, so independent assemblies may run on separate threads.
+     */
+    class Scanner
+    {
+    public:
+        Scanner() = default;
+        virtual ~Scanner();
+
+        Scanner(const Scanner &) = delete;
+        Scanner &operator=(const Scanner &) = delete;
+
+        virtual yy::parser::symbol_type next(Assembler &asmb) = 0;
+    };
+
+    std::unique_ptr<Scanner> makeScanner(ScannerType type, char *source, size_t length, bool trace);
+
+    /**
+     * A hand written scanner. Characters are classified through tables,
+     * numbers are converted as they're scanned, and the location is
+     * moved along token by token.
+     */
+    class TableScanner : public Scanner
+    {
+    public:
+        TableScanner(const char *source, size_t length);
+
+        virtual yy::parser::symbol_type next(Assembler &asmb) override;
+
+    private:
+        yy::parser::symbol_type number(Assembler &asmb, const char *start, int base);
+        yy::parser::symbol_type quotedString(Assembler &asmb);
+        yy::parser::symbol_type quotedChar(Assembler &asmb);
+        yy::parser::symbol_type word(Assembler &asmb);
+        yy::parser::symbol_type invalid(Assembler &asmb);
+
+        const char *p_;
+        const char *end_;
+    };
+
+    /**
+     * The scanner generated by flex from scanner.ll.
+     */
+    class FlexScanner : public Scanner
+    {
+    public:
+        FlexScanner(char *source, size_t length, bool trace);
+        virtual ~FlexScanner();
+
+        virtual yy::parser::symbol_type next(Assembler &asmb) override;
+
+    private:
+        yyscan_t scanner_;
+    };
 }
 
 #endif
-
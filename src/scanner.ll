@@ -22,9 +22,9 @@
 %{
 
 #include "parser.h"
+#include "except.h"
 #include "opcodes.h"
 #include "scanner.h"
-#include "utility.h"
 
 #include "parser.tab.hpp"
 
@@ -42,26 +42,23 @@ using ss = std::stringstream;
 using symtype = yy::parser::symbol_type;
 using loctype = yy::parser::location_type;
 
+#define YY_DECL symtype flexLex(yas6502::Assembler &asmb, yyscan_t yyscanner)
+YY_DECL;
+
 const int BIN = 2;
 const int DEC = 10;
 const int HEX = 16;
 
-void setInput(yas6502::Assembler &asmb);
-#define YY_USER_INIT setInput(asmb)
-
-namespace
-{
-    YY_BUFFER_STATE buffer_state;
-}
 %}
 
-%option noyywrap nounput noinput batch debug caseless 
+%option noyywrap nounput noinput batch debug caseless reentrant
 
 %{
-symtype make_STRING(const char *s, const loctype &loc);
+symtype make_STRING(const char *s, size_t len, yas6502::Assembler &asmb);
 symtype make_NUMBER(const std::string &s, int base, const loctype &loc);
 symtype make_CHAR(char ch, bool esc, const loctype &loc);
-symtype make_IdOrOpcode(const std::string &s, const yas6502::Assembler &asmb);
+symtype make_IdOrOpcode(const char *s, size_t len, yas6502::Assembler &asmb);
+void invalidCharacters(const char *s, const loctype &loc);
 %}
 
 id       [a-z_][a-z_0-9]*
@@ -120,37 +117,37 @@ rep        return yy::parser::make_REP(asmb.loc());
 '\\.'      return make_CHAR(yytext[2], true, asmb.loc());        
 '.'        return make_CHAR(yytext[1], false, asmb.loc());        
 
-\"([^\\\"]|\\.)*\"    return make_STRING(yytext, asmb.loc());
+\"([^\\\"]|\\.)*\"    return make_STRING(yytext, yyleng, asmb);
 
 \${hexint}  return make_NUMBER(yytext+1, HEX, asmb.loc());
 0x{hexint}  return make_NUMBER(yytext+2, HEX, asmb.loc());
 0b{binint}  return make_NUMBER(yytext+2, BIN, asmb.loc());
 {int}       return make_NUMBER(yytext, DEC, asmb.loc());
-{id}        return make_IdOrOpcode(yytext, asmb);
-
-;.*$       return yy::parser::make_COMMENT(yytext, asmb.loc()); 
+{id}        return make_IdOrOpcode(yytext, yyleng, asmb);
 
-
-
-.          {
-    ss err{};
-    err
-        << "Invalid character(s) `"
-        << yytext
-        << "' in input.";
-    throw yy::parser::syntax_error{
-        asmb.loc(),
-        err.str()
-    };
+;.*$       {
+    // A comment runs to the end of its line, so one without a newline 
+    // after it is left to the `.' rule as an invalid `;'.
+    //
+    return yy::parser::make_COMMENT(yas6502::Text{ yytext, static_cast<size_t>(yyleng) }, asmb.loc()); 
 }
 
+.          invalidCharacters(yytext, asmb.loc());
+
 <<EOF>> return yy::parser::make_YYEOF(asmb.loc());
 %%
 
-symtype make_STRING(const char *s, const loctype &loc)
+// Tokens with text refer to it where it is in the source buffer. Only
+// a string with escapes has to be rewritten, into the arena.
+//
+symtype make_STRING(const char *s, size_t len, yas6502::Assembler &asmb)
 {
     s++;
-    const char *end = s + strlen(s) - 1;
+    const char *end = s + len - 2;
+
+    if (std::find(s, end, '\\') == end) {
+        return yy::parser::make_STRING(yas6502::Text{ s, len - 2 }, asmb.loc());
+    }
 
     std::string out;
     bool esc = false;
@@ -178,7 +175,7 @@ symtype make_STRING(const char *s, const loctype &loc)
         out += *s;
     }
 
-    return yy::parser::make_STRING(out, loc);
+    return yy::parser::make_STRING(asmb.arena().text(out), asmb.loc());
 }
 
 symtype make_NUMBER(const std::string &s, int base, const loctype &loc)
@@ -207,29 +204,65 @@ symtype make_CHAR(char ch, bool esc, const loctype &loc)
     return yy::parser::make_NUMBER(ch, loc);
 }
 
-symtype make_IdOrOpcode(const std::string &s, const yas6502::Assembler &asmb)
+symtype make_IdOrOpcode(const char *s, size_t len, yas6502::Assembler &asmb)
 {
-    std::string upperS = yas6502::toUpper(s);
+    yas6502::opcodes::Mnemonic mnemonic = yas6502::opcodes::lookupMnemonic(s, len);
 
-    if (asmb.isOpcode(upperS)) {
-        return yy::parser::make_OPCODE(s, asmb.loc());
+    if (mnemonic != yas6502::opcodes::Mnemonic::None) {
+        return yy::parser::make_OPCODE(yas6502::ast::Opcode{ mnemonic, yas6502::Text{ s, len } }, asmb.loc());
     }
-    return yy::parser::make_IDENTIFIER(s, asmb.loc());
+    return yy::parser::make_IDENTIFIER(asmb.symtab().intern(s, len), asmb.loc());
 }
 
-void setInput(yas6502::Assembler &asmb)
+void invalidCharacters(const char *s, const loctype &loc)
 {
-    char *src = asmb.source();
-    int len = strlen(src);
-
-    // TODO find the right place to clean this up.
-    buffer_state = yy_scan_buffer(src, len+2);
+    ss err{};
+    err
+        << "Invalid character(s) `"
+        << s
+        << "' in input.";
+    throw yy::parser::syntax_error{
+        loc,
+        err.str()
+    };
 }
 
 namespace yas6502
 {
-    void cleanUpScanner()
+    /**
+     * Constructor. Creates the scanner state and points it at `source', which
+     * must be followed by two NUL bytes (i.e. the buffer must be at least
+     * `length' + 2 bytes long).
+     */
+    FlexScanner::FlexScanner(char *source, size_t length, bool trace)
+        : scanner_(nullptr)
+    {
+        if (yylex_init(&scanner_) != 0) {
+            throw Error{ "Could not initialize the scanner." };
+        }
+
+        yyset_debug(trace, scanner_);
+
+        if (yy_scan_buffer(source, length + 2, scanner_) == nullptr) {
+            yylex_destroy(scanner_);
+            throw Error{ "Source buffer is not properly terminated." };
+        }
+    }
+
+    /**
+     * Destructor. Releases the scanner state and the buffer state created
+     * over the source; the source buffer itself belongs to the caller.
+     */
+    FlexScanner::~FlexScanner()
+    {
+        yylex_destroy(scanner_);
+    }
+
+    /**
+     * Return the next token.
+     */
+    symtype FlexScanner::next(Assembler &asmb)
     {
-        yy_delete_buffer(buffer_state);
+        return flexLex(asmb, scanner_);
     }
 }
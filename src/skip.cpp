@@ -0,0 +1,128 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "skip.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace 
+{
+    // Each vector function returns a mask with a bit set for each of 
+    // the VECTOR_SIZE bytes at `p' that is of the class asked for.
+    //
+#if defined(__AVX2__)
+    const ptrdiff_t VECTOR_SIZE = 32;
+    const uint32_t ALL_BYTES = 0xFFFFFFFF;
+
+    uint32_t matchByte(const char *p, char ch)
+    {
+        __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(text, _mm256_set1_epi8(ch))));
+    }
+
+    uint32_t matchBlanks(const char *p)
+    {
+        __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i blanks = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(text, _mm256_set1_epi8(' ')),
+                _mm256_cmpeq_epi8(text, _mm256_set1_epi8('\t'))),
+            _mm256_cmpeq_epi8(text, _mm256_set1_epi8('\r')));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(blanks));
+    }
+#elif defined(__SSE2__)
+    const ptrdiff_t VECTOR_SIZE = 16;
+    const uint32_t ALL_BYTES = 0xFFFF;
+
+    uint32_t matchByte(const char *p, char ch)
+    {
+        __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(text, _mm_set1_epi8(ch))));
+    }
+
+    uint32_t matchBlanks(const char *p)
+    {
+        __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i blanks = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(text, _mm_set1_epi8(' ')),
+                _mm_cmpeq_epi8(text, _mm_set1_epi8('\t'))),
+            _mm_cmpeq_epi8(text, _mm_set1_epi8('\r')));
+        return static_cast<uint32_t>(_mm_movemask_epi8(blanks));
+    }
+#endif
+
+    bool isBlank(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r';
+    }
+}
+
+namespace yas6502
+{
+    /**
+     * Return the first character at or after `p' which isn't a blank
+     * (space, tab or carriage return).
+     */
+    const char *skipBlanks(const char *p, const char *end)
+    {
+#if defined(__AVX2__) || defined(__SSE2__)
+        while (end - p >= VECTOR_SIZE) {
+            uint32_t others = ~matchBlanks(p) & ALL_BYTES;
+            if (others != 0) {
+                return p + __builtin_ctz(others);
+            }
+            p += VECTOR_SIZE;
+        }
+#endif
+        while (p < end && isBlank(*p)) {
+            p++;
+        }
+        return p;
+    }
+
+    /**
+     * Return the first newline at or after `p'.
+     */
+    const char *findNewline(const char *p, const char *end)
+    {
+#if defined(__AVX2__) || defined(__SSE2__)
+        while (end - p >= VECTOR_SIZE) {
+            uint32_t newlines = matchByte(p, '\n');
+            if (newlines != 0) {
+                return p + __builtin_ctz(newlines);
+            }
+            p += VECTOR_SIZE;
+        }
+#endif
+        while (p < end && *p != '\n') {
+            p++;
+        }
+        return p;
+    }
+}
@@ -26,14 +26,88 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
-using std::map;
 using std::string;
+using std::vector;
 
 using ss = std::stringstream;
 
+namespace
+{
+    using yas6502::NO_SYMBOL;
+
+    // Hash table sizes must be a power of two, and tables are kept
+    // at most half full.
+    //
+    const size_t INITIAL_TABLE_SIZE = 256;
+
+    /**
+     * Hash a name, folding case so that all spellings of a symbol
+     * hash alike.
+     */
+    size_t hashName(const char *text, size_t length)
+    {
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= std::toupper(static_cast<unsigned char>(text[i]));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Check if `text' is a spelling of the upper case `name'.
+     */
+    bool sameName(const char *text, size_t length, const string &name)
+    {
+        if (length != name.length()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            if (std::toupper(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(name[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Put `index' in the first free entry at or after `hash'.
+     */
+    void insert(vector<int> &table, size_t hash, int index)
+    {
+        size_t mask = table.size() - 1;
+        size_t i = hash & mask;
+        while (table[i] != NO_SYMBOL) {
+            i = (i + 1) & mask;
+        }
+        table[i] = index;
+    }
+
+    /**
+     * If the table has become more than half full, double its size
+     * and re-insert the entries, whose names are given by `name'.
+     */
+    template<typename NameOf>
+    void grow(vector<int> &table, size_t entries, NameOf name)
+    {
+        if (2 * entries <= table.size()) {
+            return;
+        }
+
+        table.assign(2 * table.size(), NO_SYMBOL);
+        for (size_t i = 0; i < entries; i++) {
+            const string &text = name(i);
+            insert(table, hashName(text.data(), text.length()), static_cast<int>(i));
+        }
+    }
+}
+
 namespace yas6502
 {
     /**
@@ -46,63 +120,148 @@ namespace yas6502
     }
 
     /**
-     * Clear all symbols
+     * Symbol table constructor
+     */
+    SymbolTable::SymbolTable()
+    {
+        clear();
+    }
+
+    /**
+     * Clear all symbols. This also forgets all interned spellings, so
+     * must only be done before parsing.
      */
     void SymbolTable::clear()
     {
+        spellings_.clear();
+        spellingTable_.assign(INITIAL_TABLE_SIZE, NO_SYMBOL);
+
+        names_.clear();
         symbols_.clear();
+        nameTable_.assign(INITIAL_TABLE_SIZE, NO_SYMBOL);
     }
 
     /**
-     * Look up a symbol. Always returns a value, which may not yet be defined.
+     * Return the ID of the given spelling of an identifier, which need
+     * not be NUL terminated. Allocates only the first time a spelling
+     * is seen.
      */
-    Symbol SymbolTable::lookup(const string& name) const
+    int SymbolTable::intern(const char *text, size_t length)
     {
-        auto it = symbols_.find(toUpper(name));
-        if (it == symbols_.end()) {
-            return Symbol{};
+        size_t hash = hashName(text, length);
+        size_t mask = spellingTable_.size() - 1;
+
+        for (size_t i = hash & mask; spellingTable_[i] != NO_SYMBOL; i = (i + 1) & mask) {
+            int id = spellingTable_[i];
+            const string &spelling = spellings_[id].text;
+            if (spelling.length() == length && std::memcmp(spelling.data(), text, length) == 0) {
+                return id;
+            }
         }
-        return it->second;
+
+        int id = static_cast<int>(spellings_.size());
+        spellings_.push_back(Spelling{ string(text, length), findSlot(text, length, hash) });
+
+        insert(spellingTable_, hash, id);
+        grow(spellingTable_, spellings_.size(), [this](size_t i) -> const string & {
+            return spellings_[i].text; 
+        });
+
+        return id;
+    }
+
+    /**
+     * Return the slot of the symbol `text' is a spelling of, creating an
+     * undefined symbol if there is none yet.
+     */
+    int SymbolTable::findSlot(const char *text, size_t length, size_t hash)
+    {
+        size_t mask = nameTable_.size() - 1;
+
+        for (size_t i = hash & mask; nameTable_[i] != NO_SYMBOL; i = (i + 1) & mask) {
+            int slot = nameTable_[i];
+            if (sameName(text, length, names_[slot])) {
+                return slot;
+            }
+        }
+
+        int slot = static_cast<int>(names_.size());
+        names_.push_back(toUpper(string(text, length)));
+        symbols_.push_back(Symbol{});
+
+        insert(nameTable_, hash, slot);
+        grow(nameTable_, names_.size(), [this](size_t i) -> const string & {
+            return names_[i]; 
+        });
+
+        return slot;
+    }
+
+    /**
+     * Return the spelling of an identifier as it appeared in the source.
+     */
+    const string &SymbolTable::spelling(int id) const
+    {
+        return spellings_[id].text;
+    }
+
+    /**
+     * Look up a symbol. Always returns a value, which may not yet be defined.
+     */
+    Symbol SymbolTable::lookup(int id) const
+    {
+        return symbols_[spellings_[id].slot];
     }
     
     /**
      * Set the value of a symbol.
      */
-    void SymbolTable::setValue(const std::string &name, int value)
+    void SymbolTable::setValue(int id, int value)
     {
-        string uname = toUpper(name);
+        int slot = spellings_[id].slot;
+        Symbol &sym = symbols_[slot];
 
-        Symbol oldValue = symbols_[uname];
-        if (oldValue.defined && oldValue.value != value) {
-            ss err{};
+        if (sym.defined) {
+            if (sym.value != value) {
+                ss err{};
 
-            err
-                << "Cannot redefine symbol `" 
-                << uname
-                << "'.";
+                err
+                    << "Cannot redefine symbol `" 
+                    << names_[slot]
+                    << "'.";
 
-            throw Error{ err.str() };
+                throw Error{ err.str() };
+            }
+
+            // Pass 2 sets symbols again as a check, and may do so on
+            // several threads, so a symbol that is already defined is 
+            // never written.
+            //
+            return;
         }
 
-        Symbol &sym = symbols_[uname];
         sym.defined = true;
         sym.value = value;
     }
 
     /**
-     * Return an iterator to the start of the symbol table
-     */ 
-    SymbolTable::SymbolMapIter SymbolTable::begin() const
-    {
-        return symbols_.begin();
-    }
-
-    /**
-     * Return an iterator to just past the end of the symbol
-     * table
+     * Return the defined symbols, in order by their upper case names.
+     * This is built on demand and is meant for the listing.
      */
-    SymbolTable::SymbolMapIter SymbolTable::end() const
+    vector<SymbolTable::NamedSymbol> SymbolTable::byName() const
     {
-        return symbols_.end();
+        vector<NamedSymbol> symbols{};
+
+        for (size_t slot = 0; slot < symbols_.size(); slot++) {
+            if (symbols_[slot].defined) {
+                symbols.push_back(NamedSymbol{ names_[slot], symbols_[slot] });
+            }
+        }
+
+        std::sort(symbols.begin(), symbols.end(), [](const NamedSymbol &left, const NamedSymbol &right) {
+            return left.first < right.first;
+        });
+
+        return symbols;
     }
 }
@@ -22,8 +22,10 @@
 #ifndef SYMTAB_H_
 #define SYMTAB_H_
 
-#include <map>
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace yas6502
 {
@@ -35,24 +37,46 @@ namespace yas6502
         int value;
     };
 
+    // The ID of "no symbol", e.g. for a line without a label.
+    constexpr int NO_SYMBOL = -1;
+
+    // Identifiers are interned by the scanner, which hands out an ID for
+    // each distinct spelling. Symbols are case insensitive, so several
+    // spellings may refer to the same symbol; the spelling is kept so the
+    // listing and messages can show what was actually written.
+    //
     class SymbolTable
     {
     public:
+        SymbolTable();
+
         void clear();
-        Symbol lookup(const std::string &name) const;
-        void setValue(const std::string &name, int value);
+        int intern(const char *text, size_t length);
+        const std::string &spelling(int id) const;
 
-        using SymbolMap = std::map<std::string, Symbol>;
-        using SymbolMapIter = SymbolMap::const_iterator;
+        Symbol lookup(int id) const;
+        void setValue(int id, int value);
 
-        SymbolMapIter begin() const;
-        SymbolMapIter end() const;
+        using NamedSymbol = std::pair<std::string, Symbol>;
+        std::vector<NamedSymbol> byName() const;
  
     private:
-        SymbolMap symbols_;
+        struct Spelling
+        {
+            std::string text;
+            int slot;
+        };
+
+        int findSlot(const char *text, size_t length, size_t hash);
+
+        std::vector<Spelling> spellings_;
+        std::vector<int> spellingTable_;
+
+        std::vector<std::string> names_;
+        std::vector<Symbol> symbols_;
+        std::vector<int> nameTable_;
     };
 }
 
 
 #endif
-
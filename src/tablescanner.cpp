@@ -0,0 +1,480 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include "scanner.h"
+
+#include "assembler.h"
+#include "opcodes.h"
+#include "skip.h"
+
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+using ss = std::stringstream;
+using symtype = yy::parser::symbol_type;
+using token = yy::parser::token;
+
+namespace 
+{
+    // What a token starting with each character might be.
+    //
+    enum class CharClass : uint8_t
+    {
+        Invalid,
+        Blank,
+        Newline,
+        Word,
+        Digit,
+        Dollar,
+        Quote,
+        DoubleQuote,
+        Semicolon,
+        Comma,
+        Less,
+        Greater,
+        Punctuation,
+    };
+
+    const uint8_t NOT_DIGIT = 0xFF;
+
+    struct CharTable {
+        CharClass classes[256];
+        token::token_kind_type punctuation[256];
+        uint8_t digits[256];    // value as a digit in any base up to 16
+        bool word[256];         // may appear after the start of a word
+    };
+
+    constexpr CharTable makeCharTable()
+    {
+        CharTable table{};
+
+        for (int i = 0; i < 256; i++) {
+            table.classes[i] = CharClass::Invalid;
+            table.punctuation[i] = token::TOK_YYUNDEF;
+            table.digits[i] = NOT_DIGIT;
+            table.word[i] = false;
+        }
+
+        for (int ch = 'a'; ch <= 'z'; ch++) {
+            table.classes[ch] = CharClass::Word;
+            table.classes[ch - 'a' + 'A'] = CharClass::Word;
+            table.word[ch] = true;
+            table.word[ch - 'a' + 'A'] = true;
+        }
+        table.classes['_'] = CharClass::Word;
+        table.word['_'] = true;
+
+        for (int ch = '0'; ch <= '9'; ch++) {
+            table.classes[ch] = CharClass::Digit;
+            table.digits[ch] = static_cast<uint8_t>(ch - '0');
+            table.word[ch] = true;
+        }
+        for (int ch = 'a'; ch <= 'f'; ch++) {
+            table.digits[ch] = static_cast<uint8_t>(ch - 'a' + 10);
+            table.digits[ch - 'a' + 'A'] = static_cast<uint8_t>(ch - 'a' + 10);
+        }
+
+        table.classes[' '] = CharClass::Blank;
+        table.classes['\t'] = CharClass::Blank;
+        table.classes['\r'] = CharClass::Blank;
+        table.classes['\n'] = CharClass::Newline;
+        table.classes['$'] = CharClass::Dollar;
+        table.classes['\''] = CharClass::Quote;
+        table.classes['"'] = CharClass::DoubleQuote;
+        table.classes[';'] = CharClass::Semicolon;
+        table.classes[','] = CharClass::Comma;
+        table.classes['<'] = CharClass::Less;
+        table.classes['>'] = CharClass::Greater;
+
+        struct Punctuation {
+            char ch;
+            token::token_kind_type kind;
+        };
+
+        const Punctuation PUNCTUATION[] = {
+            { '=', token::TOK_EQUALS },
+            { ':', token::TOK_COLON },
+            { '#', token::TOK_HASH },
+            { '(', token::TOK_LPAREN },
+            { ')', token::TOK_RPAREN },
+            { '[', token::TOK_LBRACKET },
+            { ']', token::TOK_RBRACKET },
+            { '+', token::TOK_PLUS },
+            { '-', token::TOK_MINUS },
+            { '*', token::TOK_TIMES },
+            { '/', token::TOK_DIVIDE },
+            { '~', token::TOK_NEG },
+            { '&', token::TOK_AND },
+            { '^', token::TOK_XOR },
+            { '|', token::TOK_OR },
+            { '%', token::TOK_MOD },
+            { '.', token::TOK_DOT },
+        };
+
+        for (const Punctuation &punct : PUNCTUATION) {
+            table.classes[static_cast<uint8_t>(punct.ch)] = CharClass::Punctuation;
+            table.punctuation[static_cast<uint8_t>(punct.ch)] = punct.kind;
+        }
+
+        return table;
+    }
+
+    constexpr CharTable CHARS = makeCharTable();
+
+    struct Keyword {
+        const char *name;
+        size_t length;
+        token::token_kind_type kind;
+    };
+
+    const Keyword KEYWORDS[] = {
+        { "a", 1, token::TOK_ACCUM },
+        { "set", 3, token::TOK_SET },
+        { "org", 3, token::TOK_ORG },
+        { "rep", 3, token::TOK_REP },
+        { "end", 3, token::TOK_END },
+        { "byte", 4, token::TOK_BYTE },
+        { "word", 4, token::TOK_WORD },
+        { "bytes", 5, token::TOK_BYTES },
+        { "words", 5, token::TOK_WORDS },
+        { "ascii", 5, token::TOK_ASCII },
+        { "asciiz", 6, token::TOK_ASCIIZ },
+    };
+
+    /**
+     * Return the class of a character.
+     */
+    CharClass charClass(char ch)
+    {
+        return CHARS.classes[static_cast<uint8_t>(ch)];
+    }
+
+    /**
+     * Return the value of a character as a digit, or NOT_DIGIT.
+     */
+    unsigned digit(char ch)
+    {
+        return CHARS.digits[static_cast<uint8_t>(ch)];
+    }
+
+    /**
+     * Case insensitively compare a word with a lower case keyword of 
+     * the same length. Only the two cases of a letter are equal to it
+     * after setting bit 5.
+     */
+    bool isKeyword(const char *text, const Keyword &keyword)
+    {
+        for (size_t i = 0; i < keyword.length; i++) {
+            if ((text[i] | 0x20) != keyword.name[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+namespace yas6502
+{
+    /**
+     * Constructor. The scanner only reads the source; it must still be
+     * followed by two NUL bytes, so it can look a few characters ahead
+     * without checking for the end.
+     */
+    TableScanner::TableScanner(const char *source, size_t length)
+        : p_(source)
+        , end_(source + length)
+    {
+    }
+
+    /**
+     * Return the next token. The tokens and their locations are the 
+     * same as the flex scanner's.
+     */
+    symtype TableScanner::next(Assembler &asmb)
+    {
+        yy::location &loc = asmb.loc();
+        loc.step();
+
+        for (;;) {
+            if (p_ == end_) {
+                return yy::parser::make_YYEOF(loc);
+            }
+
+            const char *start = p_;
+
+            switch (charClass(*p_)) {
+            case CharClass::Blank:
+                p_ = skipBlanks(p_ + 1, end_);
+                loc.columns(static_cast<int>(p_ - start));
+                loc.step();
+                continue;
+
+            case CharClass::Newline:
+                while (p_ != end_ && *p_ == '\n') {
+                    p_++;
+                }
+                loc.lines(static_cast<int>(p_ - start));
+                loc.step();
+                return yy::parser::make_NEWLINE(loc);
+
+            case CharClass::Word:
+                return word(asmb);
+
+            case CharClass::Digit:
+                if (p_[0] == '0' && (p_[1] | 0x20) == 'x' && digit(p_[2]) < 16) {
+                    return number(asmb, p_ + 2, 16);
+                }
+                if (p_[0] == '0' && (p_[1] | 0x20) == 'b' && digit(p_[2]) < 2) {
+                    return number(asmb, p_ + 2, 2);
+                }
+                return number(asmb, p_, 10);
+
+            case CharClass::Dollar:
+                if (digit(p_[1]) < 16) {
+                    return number(asmb, p_ + 1, 16);
+                }
+                return invalid(asmb);
+
+            case CharClass::Quote:
+                return quotedChar(asmb);
+
+            case CharClass::DoubleQuote:
+                return quotedString(asmb);
+
+            case CharClass::Semicolon:
+                {
+                    // A comment runs to the end of its line, so one without
+                    // a newline after it is just an invalid `;'.
+                    //
+                    const char *newline = findNewline(p_ + 1, end_);
+                    if (newline == end_) {
+                        return invalid(asmb);
+                    }
+                    p_ = newline;
+                    loc.columns(static_cast<int>(p_ - start));
+                    return yy::parser::make_COMMENT(Text{ start, static_cast<size_t>(p_ - start) }, loc);
+                }
+
+            case CharClass::Comma:
+                if ((p_[1] | 0x20) == 'x') {
+                    p_ += 2;
+                    loc.columns(2);
+                    return yy::parser::make_XINDEX(loc);
+                } 
+                if ((p_[1] | 0x20) == 'y') {
+                    p_ += 2;
+                    loc.columns(2);
+                    return yy::parser::make_YINDEX(loc);
+                }
+                p_++;
+                loc.columns(1);
+                return yy::parser::make_COMMA(loc);
+
+            case CharClass::Less:
+                if (p_[1] != '<') {
+                    return invalid(asmb);
+                }
+                p_ += 2;
+                loc.columns(2);
+                return yy::parser::make_LSHIFT(loc);
+
+            case CharClass::Greater:
+                if (p_[1] != '>') {
+                    return invalid(asmb);
+                }
+                p_ += 2;
+                loc.columns(2);
+                return yy::parser::make_RSHIFT(loc);
+
+            case CharClass::Punctuation:
+                p_++;
+                loc.columns(1);
+                return symtype{ CHARS.punctuation[static_cast<uint8_t>(*start)], loc };
+
+            case CharClass::Invalid:
+                return invalid(asmb);
+            }
+        }
+    }
+
+    /**
+     * Scan a number in the given base, whose digits begin at `start'. 
+     * Like strtol(), a value too big for a long is taken as LONG_MAX.
+     */
+    symtype TableScanner::number(Assembler &asmb, const char *start, int base)
+    {
+        const char *first = p_;
+        long value = 0;
+        bool overflow = false;
+
+        unsigned d;
+        for (p_ = start; (d = digit(*p_)) < static_cast<unsigned>(base); p_++) {
+            if (value > (LONG_MAX - static_cast<long>(d)) / base) {
+                overflow = true;
+            } else {
+                value = value * base + d;
+            }
+        }
+
+        if (overflow) {
+            value = LONG_MAX;
+        }
+
+        asmb.loc().columns(static_cast<int>(p_ - first));
+        return yy::parser::make_NUMBER(static_cast<int>(value), asmb.loc());
+    }
+
+    /**
+     * Scan a string. A string may span lines, and only needs to be 
+     * copied if it has escapes.
+     */
+    symtype TableScanner::quotedString(Assembler &asmb)
+    {
+        const char *start = p_;
+        const char *q = p_ + 1;
+        bool escapes = false;
+
+        for (;;) {
+            if (q == end_) {
+                return invalid(asmb);
+            }
+            if (*q == '"') {
+                break;
+            }
+            if (*q == '\\') {
+                if (q + 1 == end_ || q[1] == '\n') {
+                    return invalid(asmb);
+                }
+                escapes = true;
+                q += 2;
+                continue;
+            }
+            q++;
+        }
+
+        p_ = q + 1;
+        asmb.loc().columns(static_cast<int>(p_ - start));
+
+        if (!escapes) {
+            return yy::parser::make_STRING(Text{ start + 1, static_cast<size_t>(q - start - 1) }, asmb.loc());
+        }
+
+        std::string out;
+        for (const char *s = start + 1; s < q; s++) {
+            if (*s == '\\') {
+                s++;
+                switch (*s) {
+                case 'n':
+                    out += '\n';
+                    continue;
+
+                case 'r':
+                    out += '\r';
+                    continue;
+                }
+            }
+            out += *s;
+        }
+
+        return yy::parser::make_STRING(asmb.arena().text(out), asmb.loc());
+    }
+
+    /**
+     * Scan a character constant, which is a number.
+     */
+    symtype TableScanner::quotedChar(Assembler &asmb)
+    {
+        char ch;
+
+        if (p_[1] == '\\' && p_[2] != '\n' && p_[3] == '\'') {
+            ch = p_[2];
+            switch (ch) {
+            case 'n':
+                ch = '\n';
+                break;
+
+            case 'r':
+                ch = '\r';
+                break;
+            }
+            p_ += 4;
+            asmb.loc().columns(4);
+        } else if (p_[1] != '\n' && p_[2] == '\'') {
+            ch = p_[1];
+            p_ += 3;
+            asmb.loc().columns(3);
+        } else {
+            return invalid(asmb);
+        }
+
+        return yy::parser::make_NUMBER(ch, asmb.loc());
+    }
+
+    /**
+     * Scan a word, which is a keyword, an opcode or an identifier.
+     */
+    symtype TableScanner::word(Assembler &asmb)
+    {
+        const char *start = p_;
+        while (CHARS.word[static_cast<uint8_t>(*p_)]) {
+            p_++;
+        }
+
+        size_t length = p_ - start;
+        asmb.loc().columns(static_cast<int>(length));
+
+        for (const Keyword &keyword : KEYWORDS) {
+            if (keyword.length == length && isKeyword(start, keyword)) {
+                return symtype{ keyword.kind, asmb.loc() };
+            }
+        }
+
+        opcodes::Mnemonic mnemonic = opcodes::lookupMnemonic(start, length);
+        if (mnemonic != opcodes::Mnemonic::None) {
+            return yy::parser::make_OPCODE(ast::Opcode{ mnemonic, Text{ start, length } }, asmb.loc());
+        }
+
+        return yy::parser::make_IDENTIFIER(asmb.symtab().intern(start, length), asmb.loc());
+    }
+
+    /**
+     * Report the character at the current position as invalid.
+     */
+    symtype TableScanner::invalid(Assembler &asmb)
+    {
+        char ch = *p_++;
+        asmb.loc().columns(1);
+
+        ss err{};
+        err << "Invalid character(s) `";
+        if (ch != '\0') {
+            err << ch;
+        }
+        err << "' in input.";
+
+        throw yy::parser::syntax_error{
+            asmb.loc(),
+            err.str()
+        };
+    }
+}
@@ -0,0 +1,87 @@
+#[[
+   Copyright 2020 Jim Geist.
+  
+   Permission is hereby granted, free of charge, to any person obtaining a copy 
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is furnished to do 
+   so, subject to the following conditions:
+  
+   The above copyright notice and this permission notice shall be included in all 
+   copies or substantial portions of the Software.
+  
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+   INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+   PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+   CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+   OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+]]
+
+# Assemble SOURCE with YAS6502, passing it OPTIONS (separated by spaces),
+# and check what it wrote in the current directory. Diagnostics, the
+# object file and the listing (with LISTING) are compared with NAME.err,
+# NAME.o and NAME.lst in EXPECTED, where those exist. With FAIL the 
+# assembly must fail and leave no object file; otherwise it must work.
+#
+# With COMPARE (options separated by spaces), SOURCE is assembled again
+# with those options, and both runs must write the same files.
+
+function(assemble suffix options)
+    separate_arguments(options)
+
+    set(object "${NAME}${suffix}.o")
+    set(args ${options} -o ${object})
+    if (LISTING)
+        list(APPEND args -l "${NAME}${suffix}.lst")
+    endif()
+
+    file(REMOVE "${object}")
+    execute_process(
+        COMMAND "${YAS6502}" ${args} "${SOURCE}"
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+        ERROR_FILE "${NAME}${suffix}.err")
+
+    if (FAIL)
+        if (result EQUAL 0)
+            message(FATAL_ERROR "${NAME}: assembly should have failed.")
+        endif()
+        if (EXISTS "${object}")
+            message(FATAL_ERROR "${NAME}: a failed assembly wrote ${object}.")
+        endif()
+    elseif (NOT result EQUAL 0)
+        file(READ "${NAME}${suffix}.err" diag)
+        message(FATAL_ERROR "${NAME}: assembly failed:\n${diag}")
+    endif()
+endfunction()
+
+function(compare expected actual)
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" -E compare_files "${expected}" "${actual}"
+        RESULT_VARIABLE result)
+
+    if (NOT result EQUAL 0)
+        file(READ "${actual}" text)
+        message(FATAL_ERROR "${NAME}: ${actual} differs from ${expected}. It is:\n${text}")
+    endif()
+endfunction()
+
+assemble("" "${OPTIONS}")
+
+foreach (ext err o lst)
+    if (EXISTS "${EXPECTED}/${NAME}.${ext}")
+        compare("${EXPECTED}/${NAME}.${ext}" "${NAME}.${ext}")
+    endif()
+endforeach()
+
+if (DEFINED COMPARE)
+    assemble("-compare" "${COMPARE}")
+
+    foreach (ext err o lst)
+        if (EXISTS "${NAME}.${ext}")
+            compare("${NAME}.${ext}" "${NAME}-compare.${ext}")
+        endif()
+    endforeach()
+endif()
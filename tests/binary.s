@@ -0,0 +1,9 @@
+; A flat binary runs from the first byte written to the last, with
+; the gaps between filled with $FF.
+;
+        ORG     $0200
+        BYTE    $01, $02
+        ORG     $0210
+        WORD    $1234
+        ORG     $0208
+        ASCII   "gap"
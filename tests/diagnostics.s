@@ -0,0 +1,15 @@
+; Warnings and errors which don't stop the statement being assembled
+; are all reported, in line order, with the right line numbers.
+;
+        ORG     $0200
+        LDA     ($10)
+        LDA     #$1FF
+        BYTE    1, 300, -1, LATER
+        LDA     [$1234,X]
+        BNE     FAR
+        STA     [$10],Y
+        LDA     UNDEFINED
+LATER:  RTS
+        BYTE    LATER
+        ORG     $0300
+FAR:    NOP
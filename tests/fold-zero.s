@@ -0,0 +1,5 @@
+; Division by a constant zero isn't folded, so it's still reported.
+;
+        BYTE    1 / 0
+        BYTE    1 % (2 - 2)
+        BYTE    (1 + 1) / (1 - 1)
@@ -0,0 +1,21 @@
+; Constant subexpressions are folded as they're compiled, but the 
+; listing still shows each expression as written. Folding must not
+; change the value of any operator, or its precedence.
+;
+        ORG     $2000
+        SET     A1 = 1 + 2 * 3 - 4 / 2
+        SET     A2 = (1 + 2) * (3 - 4)
+        SET     A3 = -7 / 2
+        SET     A4 = -7 % 3
+        SET     A5 = 1 << 4 | 3
+        SET     A6 = $F0 >> 4 & 7 ^ 1
+        SET     A7 = ~$0F & $FF
+        SET     A8 = 3 * -2 + 12
+        SET     A9 = 1 + 2 + 3 + LATER + 4 + 5
+        SET     A10 = LATER * (2 + 3)
+        BYTE    A1, A2 & $FF, A3 & $FF, A4 & $FF, A5, A6, A7, A8
+        WORD    A9, A10
+        LDA     #(LATER >> 8) & $FF
+        LDA     #LATER & $FF
+        LDA     LATER + 2 * 2
+LATER:  RTS
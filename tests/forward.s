@@ -0,0 +1,26 @@
+; Forward references of every kind. In single pass mode each statement
+; which uses one is kept as a fixup and written at the end, and the 
+; result must be the same as in two pass mode.
+;
+        ORG     $0300
+START:  JMP     MAIN
+        JSR     SUB
+        LDA     TABLE,X
+        LDA     #LOW
+        LDA     #VALUE + 256
+        BNE     NEAR
+        BEQ     START
+NEAR:   LDX     #TABLE >> 8
+        WORD    MAIN, SUB, TABLE + 1
+        BYTE    1, LOW, 2, VALUE * 2
+        WORD    REP(3) FINISH - START
+        SET     VALUE = 3
+        ORG     $0380
+MAIN:   LDA     ZP
+        STA     ZP,X
+        RTS
+SUB:    RTS
+TABLE:  BYTE    $10, $20, $30
+        SET     ZP = $F0
+        SET     LOW = TABLE & $FF
+FINISH:    BRK
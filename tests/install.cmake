@@ -0,0 +1,58 @@
+#[[
+   Copyright 2020 Jim Geist.
+  
+   Permission is hereby granted, free of charge, to any person obtaining a copy 
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is furnished to do 
+   so, subject to the following conditions:
+  
+   The above copyright notice and this permission notice shall be included in all 
+   copies or substantial portions of the Software.
+  
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+   INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+   PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+   CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+   OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+]]
+
+# Install the build in BUILD_DIR under WORK, then build and run a
+# program against the installed headers and library, as another project
+# would, to check that everything the headers include is installed.
+
+function(run description)
+    execute_process(
+        COMMAND ${ARGN}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output)
+
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "install: ${description} failed:\n${output}")
+    endif()
+endfunction()
+
+file(REMOVE_RECURSE "${WORK}")
+
+run("installing"
+    "${CMAKE_COMMAND}"
+        -DCMAKE_INSTALL_PREFIX=${WORK}/prefix
+        -DCMAKE_INSTALL_CONFIG_NAME=${CONFIG}
+        -P "${BUILD_DIR}/cmake_install.cmake")
+
+run("configuring the consumer"
+    "${CMAKE_COMMAND}"
+        -S "${SOURCE_DIR}/tests/install"
+        -B "${WORK}/consumer"
+        -DCMAKE_CXX_COMPILER=${CXX}
+        -DCMAKE_MODULE_PATH=${SOURCE_DIR}/cmake
+        -DYAS6502_ROOT_DIR=${WORK}/prefix)
+
+run("building the consumer"
+    "${CMAKE_COMMAND}" --build "${WORK}/consumer")
+
+file(GLOB consumer "${WORK}/consumer/consumer" "${WORK}/consumer/*/consumer.exe" "${WORK}/consumer/consumer.exe")
+run("running the consumer" ${consumer})
@@ -0,0 +1,55 @@
+/**
+ * Copyright 2020 Jim Geist.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy 
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do 
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **/
+#include <yas6502/assembler.h>
+#include <yas6502/except.h>
+
+#include <iostream>
+#include <vector>
+
+using std::cerr;
+using std::endl;
+
+/**
+ * Assemble one instruction through the installed headers, and check
+ * the image.
+ */
+int main()
+{
+    std::string text{ "        ORG     $1000\n        LDA     #$42\n" };
+    std::vector<char> source{ text.begin(), text.end() };
+
+    try {
+        yas6502::Assembler asmb{};
+        asmb.assemble("consumer.s", source);
+
+        const yas6502::Image &image = asmb.image();
+        if (asmb.errors() != 0 || image[0x1000] != 0xA9 || image[0x1001] != 0x42) {
+            cerr << "consumer: wrong image" << endl;
+            return 1;
+        }
+    } catch (yas6502::Error &ex) {
+        cerr << "consumer: " << ex.message() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+; Runs of bytes of different lengths, with gaps between them, at the
+; ends of memory and across the 64-bit words of the coverage bitmap.
+;
+        ORG     $0000
+        BYTE    $00
+        ORG     $0002
+        BYTE    $02, $03
+        ORG     $003E
+        BYTES   4
+        ORG     $0100
+        BYTE    REP(40) $5A
+        ORG     $0140
+        WORD    $1234, $5678
+        ORG     $0144
+        ASCII   "adjacent runs are one run"
+        ORG     $1000
+        BYTES   256
+        ORG     $FFF0
+        BYTE    REP(16) $FF
@@ -0,0 +1,28 @@
+; Encodings and clock counts, including ones the opcode table used to
+; get wrong: TAS, ORA abs,X and STY zp,X.
+;
+        ORG     $1000
+        TAS     $1234,Y
+        SHY     $1234,X
+        ORA     $1234,X
+        STY     $12,X
+        LDA     #$01
+        LDA     $12
+        LDA     $12,X
+        LDA     $1234
+        LDA     $1234,X
+        LDA     $1234,Y
+        LDA     [$12,X]
+        LDA     [$12],Y
+        LDX     $12,Y
+        STX     $1234
+        ASL     A
+        ASL     $12
+        JMP     [$1234]
+        JSR     $1234
+        BNE     .
+        BRK
+        NOP
+        LAX     [$12],Y
+        DCP     $1234,Y
+        ALR     #$0F
@@ -0,0 +1,11 @@
+; In single pass mode the JMP is written at the end, once LATER is
+; defined, so the BYTE which overlaps it through the second ORG would
+; be overwritten; that's an error. In two pass mode the BYTE wins.
+;
+        ORG     $1000
+        JMP     LATER
+        ORG     $1002
+        BYTE    $EA
+        ORG     $1003
+        BYTE    $EA
+LATER:  RTS
@@ -0,0 +1,8 @@
+; windows line ends
+        lda     #1
+
+
+        	sta$10 ; comment
+
+
+        rts
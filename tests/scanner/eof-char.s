@@ -0,0 +1 @@
+        lda     #'\'
\ No newline at end of file
@@ -0,0 +1,2 @@
+        rts
+        ; no newline
\ No newline at end of file
@@ -0,0 +1,11 @@
+        byte    0x, 0xg, 0b, 0b2, 0b12, 0x0b1, 0X1F, 0B11
+        byte    $g, $, $0x5, 123abc
+        word    2147483647, 2147483648, 4294967295, 4294967296
+        word    99999999999999999999999, $FFFFFFFFFFFFFFFFFF
+        word    0b11111111111111111111111111111111111111111111111111111111111111111
+        word    007, 0
+        lda     zp,X1
+        lda     zp,xy
+        lda     zp, x
+        lda     zp,
+        < > <<< >>> @ ` ? ! { } \
@@ -0,0 +1,16 @@
+        lda     #'x'
+        lda     #'\''
+        lda     #'\n'
+        lda     #'\r'
+        lda     #'\\'
+        lda     #'\'x
+        lda     #'''
+        lda     #''
+        ascii   "a\"b"
+        ascii   "tab\tnl\ncr\r"
+        ascii   ""
+        ascii   "two
+lines"
+        ascii   "ab\
+c"
+        ascii   "unterminated
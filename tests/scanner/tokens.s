@@ -0,0 +1,26 @@
+; every kind of token
+start:  LDA     #$1F            ; hex
+        lda     #0x1f
+        Lda     #0b101
+        ldx     #123
+        STA     table,X
+        sta     table,x
+        LDA     [zp],Y
+        lda     [zp,x]
+        asl     a
+        ASL     A
+        SET     value = (1 + 2 - 3 * 4 / 5 % 6) << 1 >> 2
+        set     mask = ~1 & $FF ^ 3 | 4
+        ORG     $1000
+        org     .
+        BYTE    1, 2, 3
+        WORD    $1234
+        BYTES   4
+        WORDS   2
+        ASCII   "hello"
+        ASCIIZ  "world"
+        REP     3
+        END
+        Rep     2
+        end
+a1      settle  orgs    words1  _under  a
@@ -0,0 +1,10 @@
+; STY has no absolute,X mode, so once FWD is known to be in zero page
+; pass 2 falls back to zero page,X, and the statement is a byte shorter
+; than pass 1 left for it. Two pass mode carries on from where pass 2
+; got to; in single pass mode the NOPs have already been placed, so 
+; this is an error.
+;
+        ORG     $10
+        STY     FWD,X
+        NOP
+FWD:    NOP
@@ -0,0 +1,3 @@
+        JMP     LATER
+        LDA     #1 +
+LATER:  RTS
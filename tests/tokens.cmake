@@ -0,0 +1,41 @@
+#[[
+   Copyright 2020 Jim Geist.
+  
+   Permission is hereby granted, free of charge, to any person obtaining a copy 
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is furnished to do 
+   so, subject to the following conditions:
+  
+   The above copyright notice and this permission notice shall be included in all 
+   copies or substantial portions of the Software.
+  
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+   INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+   PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+   CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+   OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+]]
+
+# Scan SOURCE with the SCANNER scanner of SCANBENCH, and compare the 
+# tokens it finds with EXPECTED.
+
+execute_process(
+    COMMAND "${SCANBENCH}" -d ${SCANNER} "${SOURCE}"
+    RESULT_VARIABLE result
+    OUTPUT_FILE "${NAME}.tokens")
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${NAME}: scanning failed.")
+endif()
+
+execute_process(
+    COMMAND "${CMAKE_COMMAND}" -E compare_files "${EXPECTED}" "${NAME}.tokens"
+    RESULT_VARIABLE result)
+
+if (NOT result EQUAL 0)
+    file(READ "${NAME}.tokens" text)
+    message(FATAL_ERROR "${NAME}: ${NAME}.tokens differs from ${EXPECTED}. It is:\n${text}")
+endif()